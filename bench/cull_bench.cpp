@@ -0,0 +1,89 @@
+// Microbenchmark for the AABB cull kernels (math/aabb_cull.h).
+// Not a test: prints ns per entity for every kernel the CPU supports and
+// checks that they all produce the same visible list.
+
+#include "math/aabb_cull.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace argon;
+
+namespace {
+
+	struct Boxes {
+		std::vector<float> minX, minY, maxX, maxY;
+
+		AabbArrays arrays() const { return { minX.data(), minY.data(), maxX.data(), maxY.data() }; }
+	};
+
+	// sprites scattered over a 200x200 world, the view sees roughly 5% of them
+	Boxes makeBoxes(std::size_t n, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> half(0.02f, 0.5f);
+
+		Boxes b;
+		b.minX.resize(n); b.minY.resize(n); b.maxX.resize(n); b.maxY.resize(n);
+		for (std::size_t i = 0; i < n; ++i) {
+			const float x = pos(rng), y = pos(rng), hw = half(rng), hh = half(rng);
+			b.minX[i] = x - hw; b.maxX[i] = x + hw;
+			b.minY[i] = y - hh; b.maxY[i] = y + hh;
+		}
+		return b;
+	}
+
+	double runKernel(CullKernel kernel, const Boxes& boxes, const CullRect& view,
+					 std::vector<std::uint32_t>& out, std::size_t& visible) {
+		const std::size_t n = boxes.minX.size();
+		// enough repetitions for ~50M box tests per kernel
+		const int reps = (int)std::max<std::size_t>(5, 50000000 / n);
+
+		using clock = std::chrono::steady_clock;
+		double best = 1e30;
+		for (int r = 0; r < reps; ++r) {
+			const auto t0 = clock::now();
+			visible = cullAabbsWith(kernel, boxes.arrays(), 0, n, view, out.data());
+			const double ns = std::chrono::duration<double, std::nano>(clock::now() - t0).count();
+			best = std::min(best, ns);
+		}
+		return best / (double)n;
+	}
+}
+
+int main() {
+	const std::size_t sizes[] = { 10000, 100000, 1000000 };
+	const CullKernel kernels[] = { CullKernel::Scalar, CullKernel::SSE2, CullKernel::AVX2 };
+	const CullRect view{ -22.0f, -22.0f, 22.0f, 22.0f };
+
+	std::printf("best kernel: %s\n", cullKernelName(bestCullKernel()));
+	std::printf("%10s %8s %12s %10s %8s\n", "entities", "kernel", "ns/entity", "visible", "speedup");
+
+	bool ok = true;
+	for (std::size_t n : sizes) {
+		const Boxes boxes = makeBoxes(n, 1234u);
+		std::vector<std::uint32_t> reference(n), out(n);
+
+		std::size_t refVisible = 0;
+		const double scalarNs = runKernel(CullKernel::Scalar, boxes, view, reference, refVisible);
+
+		for (CullKernel k : kernels) {
+			if (!cullKernelSupported(k)) {
+				std::printf("%10zu %8s %12s\n", n, cullKernelName(k), "n/a");
+				continue;
+			}
+			std::size_t visible = 0;
+			const double ns = k == CullKernel::Scalar ? scalarNs : runKernel(k, boxes, view, out, visible);
+			if (k == CullKernel::Scalar) visible = refVisible;
+			else if (visible != refVisible || !std::equal(out.begin(), out.begin() + visible, reference.begin())) {
+				std::printf("MISMATCH: %s disagrees with scalar at %zu entities\n", cullKernelName(k), n);
+				ok = false;
+			}
+			std::printf("%10zu %8s %12.3f %10zu %7.2fx\n", n, cullKernelName(k), ns, visible, scalarNs / ns);
+		}
+	}
+	return ok ? 0 : 1;
+}
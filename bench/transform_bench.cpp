@@ -0,0 +1,135 @@
+// Microbenchmark for the per-entity transform cost (math/affine2d.h, math/mat4.h).
+// Not a test: prints ns per entity for the old Mat4 path and the Affine2D path,
+// and checks that both produce the same matrices.
+
+#include "math/affine2d.h"
+#include "math/mat4.h"
+#include "math/transform.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace argon;
+
+namespace {
+
+	std::vector<Transform> makeTransforms(std::size_t n, std::uint32_t seed) {
+		std::mt19937 rng(seed);
+		std::uniform_real_distribution<float> pos(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> rot(-3.14159f, 3.14159f);
+		std::uniform_real_distribution<float> scl(0.05f, 2.0f);
+
+		std::vector<Transform> out(n);
+		for (Transform& t : out) {
+			t.x = pos(rng); t.y = pos(rng);
+			t.rotation = rot(rng);
+			t.sx = scl(rng); t.sy = scl(rng);
+		}
+		return out;
+	}
+
+	// Transform::matrix() before Affine2D: three Mat4s, two 4x4 products
+	template<class MulFn>
+	Mat4 composeMat4(const Transform& t, MulFn&& mulFn) {
+		const Mat4 T = Mat4::translate(t.x, t.y, 0.0f);
+		const Mat4 R = Mat4::rotateZ(t.rotation);
+		const Mat4 S = Mat4::scale(t.sx, t.sy, 1.0f);
+		return mulFn(T, mulFn(R, S));
+	}
+
+	// best of several runs, ns per entity
+	template<class Fn>
+	double timeIt(std::size_t n, Fn&& fn) {
+		const int reps = (int)std::max<std::size_t>(5, 20000000 / n);
+		using clock = std::chrono::steady_clock;
+		double best = 1e30;
+		for (int r = 0; r < reps; ++r) {
+			const auto t0 = clock::now();
+			fn();
+			best = std::min(best, std::chrono::duration<double, std::nano>(clock::now() - t0).count());
+		}
+		return best / (double)n;
+	}
+
+	bool nearlyEqual(const Mat4& a, const Mat4& b) {
+		for (int i = 0; i < 16; ++i) {
+			if (std::abs(a.m[i] - b.m[i]) > 1e-4f * (1.0f + std::abs(a.m[i]))) return false;
+		}
+		return true;
+	}
+
+	volatile float g_sink = 0.0f;
+}
+
+int main() {
+	const std::size_t sizes[] = { 10000, 100000 };
+	const Mat4 PV = Mat4::ortho(-16.0f, 16.0f, -9.0f, 9.0f);
+
+#if defined(ARGON_MAT4_SSE)
+	std::printf("Mat4 mul: sse\n");
+#elif defined(ARGON_MAT4_NEON)
+	std::printf("Mat4 mul: neon\n");
+#else
+	std::printf("Mat4 mul: scalar\n");
+#endif
+	std::printf("%10s %-34s %12s\n", "entities", "path", "ns/entity");
+
+	bool ok = true;
+	for (std::size_t n : sizes) {
+		const std::vector<Transform> ts = makeTransforms(n, 1234u);
+		std::vector<Mat4> mats(n), mvps(n);
+		std::vector<Affine2D> affs(n);
+
+		const auto print = [&](const char* name, double ns) {
+			std::printf("%10zu %-34s %12.3f\n", n, name, ns);
+		};
+
+		// model matrix only
+		print("model: Mat4 T*R*S, scalar mul", timeIt(n, [&] {
+			for (std::size_t i = 0; i < n; ++i) mats[i] = composeMat4(ts[i], mulScalar);
+		}));
+		const std::vector<Mat4> reference = mats;
+
+		print("model: Mat4 T*R*S, simd mul", timeIt(n, [&] {
+			for (std::size_t i = 0; i < n; ++i) mats[i] = composeMat4(ts[i], [](const Mat4& a, const Mat4& b) { return mul(a, b); });
+		}));
+		print("model: Affine2D::trs", timeIt(n, [&] {
+			for (std::size_t i = 0; i < n; ++i) affs[i] = ts[i].affine();
+		}));
+
+		for (std::size_t i = 0; i < n; ++i) {
+			if (!nearlyEqual(reference[i], affs[i].toMat4()) || !nearlyEqual(reference[i], mats[i])) {
+				std::printf("MISMATCH: model matrix %zu\n", i);
+				ok = false;
+				break;
+			}
+		}
+
+		// PV * model, the non-batched draw path
+		print("mvp: Mat4 * Mat4, scalar", timeIt(n, [&] {
+			for (std::size_t i = 0; i < n; ++i) mvps[i] = mulScalar(PV, reference[i]);
+		}));
+		const std::vector<Mat4> mvpReference = mvps;
+
+		print("mvp: Mat4 * Mat4, simd", timeIt(n, [&] {
+			for (std::size_t i = 0; i < n; ++i) mvps[i] = mul(PV, reference[i]);
+		}));
+		print("mvp: Mat4 * Affine2D", timeIt(n, [&] {
+			for (std::size_t i = 0; i < n; ++i) mvps[i] = mul(PV, affs[i]);
+		}));
+
+		for (std::size_t i = 0; i < n; ++i) {
+			if (!nearlyEqual(mvpReference[i], mvps[i])) {
+				std::printf("MISMATCH: mvp %zu\n", i);
+				ok = false;
+				break;
+			}
+		}
+
+		g_sink = mats[n / 2].m[0] + affs[n / 2].a + mvps[n / 2].m[0];
+	}
+	return ok ? 0 : 1;
+}
@@ -1,26 +1,31 @@
 ﻿#include "sandbox.h"
 #include "math/mat4.h"
 #include <cmath>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include "imgui.h"
 #include "backends/imgui_impl_glfw.h"
 #include "backends/imgui_impl_opengl3.h"
+#include "renderer/atlas_builder.h"
+#include "renderer/gl_extensions.h"
+#include "renderer/gl_state_tracker.h"
+#include "renderer/pass_constants.h"
+#include "renderer/program_cache.h"
 #include <string_view>
 
 namespace argon {
-	static const char* vsBasic = R"(
-	#version 330 core
+	static const char* vsBasic = "#version 330 core\n" ARGON_PASS_CONSTANTS_GLSL R"(
 	layout (location = 0) in vec2 aPos;
 	layout (location = 1) in vec2 aUV;
 	
-	uniform mat4 uMVP;
+	uniform mat4 uModel;
 	uniform vec4 uUVRect; // (u0,v0,u1,v1)
 	out vec2 vUV;
 	
 	void main() {
 	    vUV = mix(uUVRect.xy, uUVRect.zw, aUV);
-	    gl_Position = uMVP * vec4(aPos, 0.0, 1.0);
+	    gl_Position = uPV * uModel * vec4(aPos, 0.0, 1.0);
 	}
 	)";
 	
@@ -30,18 +35,72 @@ namespace argon {
 	in vec2 vUV;
 	
 	uniform sampler2D uTex;
-	uniform int uUseTex;
 	uniform vec4 uColor;
 	
 	void main() {
-	    vec4 base = uColor;
-	    if (uUseTex == 1) base *= texture(uTex, vUV);
+	    vec4 base = vec4(1.0);
+	#ifdef ARGON_TINTED
+	    base *= uColor;
+	#endif
+	#ifdef ARGON_TEXTURED
+	    base *= texture(uTex, vUV);
+	#endif
+	#ifdef ARGON_ALPHA_TEST
+	    if (base.a < ARGON_ALPHA_CUTOFF) discard;
+	#endif
 	    FragColor = base;
 	}
 )";
 
-	static const char* vsInstanced = R"(
+	// batched basic meshes: no attributes, the vertex and its draw are fetched
+	// through texture buffers (see MeshBatcher); fsMeshBatch mirrors fsBasic
+	static const char* vsMeshBatch = "#version 330 core\n" ARGON_PASS_CONSTANTS_GLSL R"(
+	uniform samplerBuffer uGeometry; // per vertex: x, y, u, v
+	uniform samplerBuffer uDraws;    // per draw: (a, b, c, d), (tx, ty, first, 0), color, uvRect
+	uniform int uDrawShift;
+
+	out vec2 vUV;
+	flat out vec4 vColor;
+
+	void main() {
+		int draw = gl_VertexID >> uDrawShift;
+		int local = gl_VertexID & ((1 << uDrawShift) - 1);
+		vec4 m = texelFetch(uDraws, draw * 4);
+		vec4 t = texelFetch(uDraws, draw * 4 + 1);
+		vec4 uvRect = texelFetch(uDraws, draw * 4 + 3);
+		vColor = texelFetch(uDraws, draw * 4 + 2);
+
+		vec4 v = texelFetch(uGeometry, int(t.z) + local);
+		vUV = mix(uvRect.xy, uvRect.zw, v.zw);
+		vec2 p = m.xy * v.x + m.zw * v.y + t.xy;
+		gl_Position = uPV * vec4(p, 0.0, 1.0);
+	}
+	)";
+
+	static const char* fsMeshBatch = R"(
 	#version 330 core
+	out vec4 FragColor;
+	in vec2 vUV;
+	flat in vec4 vColor;
+
+	uniform sampler2D uTex;
+
+	void main() {
+	    vec4 base = vec4(1.0);
+	#ifdef ARGON_TINTED
+	    base *= vColor;
+	#endif
+	#ifdef ARGON_TEXTURED
+	    base *= texture(uTex, vUV);
+	#endif
+	#ifdef ARGON_ALPHA_TEST
+	    if (base.a < ARGON_ALPHA_CUTOFF) discard;
+	#endif
+	    FragColor = base;
+	}
+	)";
+
+	static const char* vsInstanced = "#version 330 core\n" ARGON_PASS_CONSTANTS_GLSL R"(
 	layout (location = 0) in vec2 aPos;
 	layout (location = 1) in vec2 aUV;
 	
@@ -53,36 +112,107 @@ namespace argon {
 
 	layout (location = 6) in vec4 iColor;
 	layout (location = 7) in vec4 iUVRect; // (u0,v0,u1,v1)
+	layout (location = 8) in uint iTexSlot;
 
-	uniform mat4 uPV;
 
 	out vec2 vUV;
 	out vec4 vColor;
+	flat out uint vTexSlot;
 
 	void main() {
 		vUV = mix(iUVRect.xy, iUVRect.zw, aUV);
 		vColor = iColor;
+		vTexSlot = iTexSlot;
 		mat4 model = mat4(iM0, iM1, iM2, iM3);
 		gl_Position = uPV * model * vec4(aPos, 0.0, 1.0);
 	}
 	)";
 
+	// 32-byte instances: 2x3 affine split into translation + half-float 2x2
+	static const char* vsInstancedCompact = "#version 330 core\n" ARGON_PASS_CONSTANTS_GLSL R"(
+	layout (location = 0) in vec2 aPos;
+	layout (location = 1) in vec2 aUV;
+
+	layout (location = 2) in vec2 iTranslate;
+	layout (location = 3) in vec4 iLinear; // column-major 2x2 (m00, m10, m01, m11)
+	layout (location = 6) in vec4 iColor;
+	layout (location = 7) in vec4 iUVRect; // (u0,v0,u1,v1)
+	layout (location = 8) in uint iTexSlot;
+
+
+	out vec2 vUV;
+	out vec4 vColor;
+	flat out uint vTexSlot;
+
+	void main() {
+		vUV = mix(iUVRect.xy, iUVRect.zw, aUV);
+		vColor = iColor;
+		vTexSlot = iTexSlot;
+		vec2 p = iLinear.xy * aPos.x + iLinear.zw * aPos.y + iTranslate;
+		gl_Position = uPV * vec4(p, 0.0, 1.0);
+	}
+	)";
+
+	// 36-byte instances: raw Transform fields, the model is built here
+	static const char* vsInstancedTrs = "#version 330 core\n" ARGON_PASS_CONSTANTS_GLSL R"(
+	layout (location = 0) in vec2 aPos;
+	layout (location = 1) in vec2 aUV;
+
+	layout (location = 2) in vec2 iPos;
+	layout (location = 3) in float iRotation;
+	layout (location = 4) in vec2 iScale;
+	layout (location = 6) in vec4 iColor;
+	layout (location = 7) in vec4 iUVRect; // (u0,v0,u1,v1)
+	layout (location = 8) in uint iTexSlot;
+
+
+	out vec2 vUV;
+	out vec4 vColor;
+	flat out uint vTexSlot;
+
+	void main() {
+		vUV = mix(iUVRect.xy, iUVRect.zw, aUV);
+		vColor = iColor;
+		vTexSlot = iTexSlot;
+		// translate * rotate * scale, as Transform::affine()
+		float c = cos(iRotation);
+		float s = sin(iRotation);
+		vec2 q = aPos * iScale;
+		vec2 p = vec2(c * q.x - s * q.y, s * q.x + c * q.y) + iPos;
+		gl_Position = uPV * vec4(p, 0.0, 1.0);
+	}
+	)";
+
 	static const char* fsInstanced = R"(
 	#version 330 core
 	out vec4 FragColor;
 
 	in vec2 vUV;
-    in vec4 vColor;	
-
-	uniform sampler2D uTex;
-	uniform int uUseTex;
+	in vec4 vColor;
+	flat in uint vTexSlot;
+
+	// one unit per batch texture slot, untextured sprites point at a white texel
+	uniform sampler2D uTex[8];
+
+	vec4 sampleSlot(vec2 uv) {
+		// GLSL 3.30 only indexes sampler arrays with constants; explicit
+		// gradients keep filtering well defined inside the divergent switch
+		vec2 dx = dFdx(uv);
+		vec2 dy = dFdy(uv);
+		switch (vTexSlot) {
+			case 0u: return textureGrad(uTex[0], uv, dx, dy);
+			case 1u: return textureGrad(uTex[1], uv, dx, dy);
+			case 2u: return textureGrad(uTex[2], uv, dx, dy);
+			case 3u: return textureGrad(uTex[3], uv, dx, dy);
+			case 4u: return textureGrad(uTex[4], uv, dx, dy);
+			case 5u: return textureGrad(uTex[5], uv, dx, dy);
+			case 6u: return textureGrad(uTex[6], uv, dx, dy);
+			default: return textureGrad(uTex[7], uv, dx, dy);
+		}
+	}
 
 	void main() {
-		vec4 base = vColor;
-		if (uUseTex == 1) {
-			base *= texture(uTex, vUV);
-		}
-		FragColor = base;
+		FragColor = vColor * sampleSlot(vUV);
 	}
 	)";
 
@@ -112,26 +242,45 @@ namespace argon {
 		glfwSwapInterval(0);
 
 		std::cout << "OpenGL Version: " << glGetString(GL_VERSION) << "\n";
+		loadGLExtensions((GLADloadproc)glfwGetProcAddress);
+		std::cout << "buffer_storage=" << glExt().bufferStorage
+				  << " base_instance=" << glExt().baseInstance
+				  << " program_binary=" << glExt().programBinary << "\n";
+		setProgramCacheDirectory("cache/shaders");
 		
-		m_basicShader = std::make_unique<Shader>(vsBasic, fsBasic);
+		// all variants are built up front: none compiles mid-frame, and the cache
+		// stats below cover every program the sandbox can use
+		m_basicShaders = std::make_unique<ShaderPermutations>(vsBasic, fsBasic);
 		m_spriteShader = std::make_unique<Shader>(vsInstanced, fsInstanced);
+		m_spriteCompactShader = std::make_unique<Shader>(vsInstancedCompact, fsInstanced);
+		m_spriteTrsShader = std::make_unique<Shader>(vsInstancedTrs, fsInstanced);
+		m_meshBatchShaders = std::make_unique<ShaderPermutations>(vsMeshBatch, fsMeshBatch);
 
-		if (!m_basicShader->id() || !m_spriteShader->id()) {
+		if (!m_basicShaders->prewarm() || !m_spriteShader->id() || !m_spriteCompactShader->id() ||
+			!m_spriteTrsShader->id() || !m_meshBatchShaders->prewarm()) {
 			std::cerr << "Failed to create shader program.\n";
 			return false;
 		}
+		const ProgramCacheStats& pcs = programCacheStats();
+		std::cout << "programCache hits=" << pcs.hits << " misses=" << pcs.misses
+				  << " rejected=" << pcs.rejected << " compileMs=" << pcs.compileMs
+				  << " loadMs=" << pcs.loadMs << " savedMs=" << pcs.savedMs << "\n";
 
 		m_input.bind(Action::MoveLeft, GLFW_KEY_A);
 		m_input.bind(Action::MoveRight, GLFW_KEY_D);
 		m_input.bind(Action::MoveUp, GLFW_KEY_W);
 		m_input.bind(Action::MoveDown, GLFW_KEY_S);
 
+		m_jobs = std::make_unique<ThreadPool>();
+		m_textureLoader = std::make_unique<AsyncTextureLoader>(*m_jobs);
+
+		// decoded on the pool, materials point at placeholders until the uploads land
 		const int numTextures = 8;
 		m_textures.clear();
 		m_textures.reserve(numTextures);
 		for (int i = 0; i < numTextures; ++i) {
 			std::string path = "assets/texture" + std::to_string(i) + ".jpg";
-			m_textures.push_back(std::make_unique<Texture2D>(path.c_str()));
+			m_textures.push_back(m_textureLoader->load(path));
 		}
 
 		m_matHandles.clear();
@@ -140,8 +289,8 @@ namespace argon {
 		for (int i = 0; i < numTextures; ++i) {
 			Material2D m;
 			m.shader = m_spriteShader.get();
-			m.texture = m_textures[i].get();
-			m.useTexture = true;
+			m.texture = m_textures[i];
+			m.features = kShaderTextured | kShaderTinted;
 			m.color = { 1,1,1,1 };
 			m_matHandles.push_back(m_materials.add(m));
 		}
@@ -164,8 +313,17 @@ namespace argon {
 			-0.5f, 0.5f, 0.f, 1.f
 		});
 
+		m_renderer.setThreadPool(m_jobs.get());
+		m_renderSys.setThreadPool(m_jobs.get());
+		m_renderer.setFrameArena(&m_frameArena);
+		m_renderSys.setFrameArena(&m_frameArena);
+		m_frame2d.arena = &m_frameArena;
 		m_renderer.setSpriteQuad(m_quad.get());
 		m_renderer.setInstancedSpriteShader(m_spriteShader.get());
+		m_renderer.setMeshBatchShaders(m_basicShaders.get(), m_meshBatchShaders.get());
+		m_renderer.setCompactSpriteShader(m_spriteCompactShader.get());
+		m_renderer.setTrsSpriteShader(m_spriteTrsShader.get());
+		m_renderer.setSpriteInstanceLayout(SpriteInstanceLayout::Trs);
 
 		m_camera.size = 1.0f;
 		m_camera.zoom = 1.0f;
@@ -173,31 +331,49 @@ namespace argon {
 		m_camera.y = 0.0f;
 
 		m_camCtl = std::make_unique<CameraController2D>(*m_window, m_camera);
-		m_testTex = std::make_unique<Texture2D>("assets/texture0.jpg");
-		m_atlasTex = std::make_unique<Texture2D>("assets/test_atlas.png");
+		m_testTex = m_textureLoader->load("assets/texture0.jpg");
+		// test_atlas.atex is cooked by argon_cook at build time, the source assets are the fallback
+		const bool cookedAtlas = std::ifstream("assets/test_atlas.atex").good();
+		m_atlasTex = std::make_unique<Texture2D>(cookedAtlas ? "assets/test_atlas.atex" : "assets/test_atlas.png");
 
-		m_scene.entities.clear();
-		m_scene.entities.reserve(numQuads);
+		m_scene.clear();
+		m_scene.reserve(numQuads + 2400 + 2 + 64);
+		// cells of 5x5 quads; the camera query touches only the cells in view
+		m_scene.enableSpatialIndex(0.25f);
 
 		Material2D matTex;
-		matTex.shader = m_basicShader.get();
-		matTex.texture = m_testTex.get();
-		matTex.useTexture = true;
+		matTex.permutations = m_basicShaders.get();
+		matTex.features = kShaderTextured;
+		matTex.texture = m_testTex;
 		matTex.color = { 1.0f,1.0f,1.0f,1.0f };
 		m_matTex = m_materials.add(matTex);
 
 		Material2D matAtlas;
 		matAtlas.shader = m_spriteShader.get();
 		matAtlas.texture = m_atlasTex.get();
-		matAtlas.useTexture = true;
+		matAtlas.features = kShaderTextured | kShaderTinted;
 		matAtlas.color = { 1,1,1,1 };
 		MaterialHandle m_matAtlas = m_materials.add(matAtlas);
 
 		m_atlas.setTextureSize(1024, 1024);
-		bool ok = m_atlas.loadFromFile("assets/test.atlas");
-		std::cout << "atlas load ok=" << ok << "\n";
+		bool ok = m_atlas.loadFromFile(cookedAtlas ? "assets/test_atlas.atex" : "assets/test.atlas");
+		std::cout << "atlas load ok=" << ok << " cooked=" << cookedAtlas
+			<< " texture " << m_atlasTex->loadStats().totalMs() << " ms"
+			<< " (io " << m_atlasTex->loadStats().ioMs << ", decode " << m_atlasTex->loadStats().decodeMs
+			<< ", upload " << m_atlasTex->loadStats().uploadMs << ")"
+			<< " rects " << m_atlas.loadStats().totalMs() << " ms\n";
 		m_renderer.setAtlas(&m_atlas);
 
+		// the loose textures packed onto extra atlas pages: one material per page
+		// instead of one per image, so the row below batches per page
+		AtlasBuilder packer;
+		for (int i = 0; i < numTextures; ++i) {
+			packer.addFile("loose" + std::to_string(i), "assets/texture" + std::to_string(i) + ".jpg");
+		}
+		const AtlasBuilder::Result packed = packer.build(m_atlas);
+		m_atlas.createPageMaterials(m_materials, matAtlas);
+		std::cout << "atlas packed " << packed.ids.size() << " images on " << packed.pages.size() << " pages\n";
+
 		m_animHero.frames = {
 			m_atlas.getId("hero0"),
 			m_atlas.getId("hero1"),
@@ -211,6 +387,26 @@ namespace argon {
 		m_animCoin.fps = 10.0f;
 		m_animCoin.loop = true;
 
+		// static background on layer 0: baked once, one draw per visible chunk
+		m_scene.setLayerStatic(0, true);
+		m_renderer.setStaticChunkSize(1.0f);
+		const std::uint32_t bgSprite = m_atlas.getId("coin0");
+		for (int y = 0; y < 40; ++y) {
+			for (int x = 0; x < 60; ++x) {
+				EntityDesc bg;
+				bg.renderable.mesh = m_quad.get();
+				bg.renderable.material = m_matAtlas;
+				bg.renderable.spriteId = bgSprite;
+				bg.renderable.layer = 0;
+				bg.renderable.tint = { 0.25f, 0.25f, 0.3f, 1.0f };
+				bg.transform.x = -2.95f + x * 0.1f;
+				bg.transform.y = -1.95f + y * 0.1f;
+				bg.transform.sx = 0.09f;
+				bg.transform.sy = 0.09f;
+				m_scene.spawn(bg);
+			}
+		}
+
 		const float spacing = 0.05f;
 		const float startX = -(gridW - 1) * spacing * 0.5f;
 		const float startY = -(gridH - 1) * spacing * 0.5f;
@@ -219,7 +415,7 @@ namespace argon {
 
 		for (int y = 0; y < gridH; ++y) {
 			for (int x = 0; x < gridW; ++x) {
-				Entity e;
+				EntityDesc e;
 				e.renderable.mesh = m_quad.get();
 				int idx = (x + y * gridW) % numTextures;
 				e.renderable.material = m_matAtlas;
@@ -238,36 +434,68 @@ namespace argon {
 				e.transform.y = startY + y * spacing;
 				e.transform.sx = 0.05f;   
 				e.transform.sy = 0.05f;
-				e.renderable.layer = 0;
+				e.renderable.layer = 1;
 				e.renderable.tint = { (float)(x % 10) / 9.0f, (float)(y % 10) / 9.0f, 1.0f, 1.0f };
-				m_scene.entities.push_back(e);
+				const EntityId id = m_scene.spawn(e);
+				if (m_spinner == kInvalidEntity) m_spinner = id;
+				else if (m_bobber == kInvalidEntity) m_bobber = id;
 			}
 		}
 
 		Material2D matColor;
-		matColor.shader = m_basicShader.get();
+		matColor.permutations = m_basicShaders.get();
+		matColor.features = kShaderTinted;
 		matColor.texture = nullptr;
-		matColor.useTexture = false;
 		matColor.color = { 0.2f, 0.8f, 0.3f, 1.0f };
 		m_matColor = m_materials.add(matColor);
 
-		Entity e1;
+		EntityDesc e1;
 		e1.renderable.mesh = m_quad.get();
 		e1.renderable.material = m_matTex;
 		e1.renderable.layer = 10;
 		e1.transform.x = -0.7;
 		
-		Entity e2;
+		EntityDesc e2;
 		e2.renderable.mesh = m_tri.get();
 		e2.renderable.material = m_matColor;
 		e2.renderable.layer = 10;
 		e2.transform.x = 0.7;
 
-		m_scene.entities.push_back(e1);
-		m_scene.entities.push_back(e2);
+		m_scene.spawn(e1);
+		m_scene.spawn(e2);
+
+		for (std::size_t i = 0; i < packed.ids.size(); ++i) {
+			if (packed.ids[i] == 0) continue;
+			EntityDesc loose;
+			loose.renderable.mesh = m_quad.get();
+			loose.renderable.material = m_matAtlas;
+			loose.renderable.spriteId = packed.ids[i];
+			loose.renderable.layer = 10;
+			loose.transform.x = -0.7f + (float)i * 0.2f;
+			loose.transform.y = -1.2f;
+			loose.transform.sx = 0.18f;
+			loose.transform.sy = 0.18f;
+			m_scene.spawn(loose);
+		}
+
+		// a ring of basic triangles: one multi-draw instead of one draw each
+		for (int i = 0; i < 64; ++i) {
+			const float angle = (float)i * (6.2831853f / 64.0f);
+			EntityDesc tri;
+			tri.renderable.mesh = m_tri.get();
+			tri.renderable.material = m_matColor;
+			tri.renderable.layer = 10;
+			tri.renderable.tint = { 0.5f + 0.5f * std::cos(angle), 1.0f, 0.5f + 0.5f * std::sin(angle), 1.0f };
+			tri.transform.x = 1.6f * std::cos(angle);
+			tri.transform.y = 1.6f * std::sin(angle);
+			tri.transform.rotation = angle;
+			tri.transform.sx = 0.08f;
+			tri.transform.sy = 0.08f;
+			m_scene.spawn(tri);
+		}
 
-		if (!m_scene.entities.empty())
-			m_scene.entities[0].controllable = true;
+		if (m_scene.registry.alive(m_spinner))
+			m_scene.registry.add<Controllable>(m_spinner);
 
 		m_pipeline2d = RenderPipeline2D{};
 		m_pipeline2d.setRenderSystem(& m_renderSys);
@@ -285,11 +513,14 @@ namespace argon {
 		ImGui_ImplGlfw_Shutdown();
 		ImGui::DestroyContext();
 
+		m_textureLoader.reset();
+		m_testTex = nullptr;
+		m_textures.clear();
+
 		m_tri.reset();
 		m_window.reset();
 		m_camCtl.reset();
 		m_quad.reset();
-		m_testTex.reset();
 	} 
 
 	void SandboxApp::update(float dt) {
@@ -300,21 +531,30 @@ namespace argon {
 		}
 
 		m_time += dt;
+		m_frameDt = dt;
 		m_pulse = 0.5f + 0.5f * std::sin((float)m_time);
 
 		FrameContext ctx{ *m_window, m_input, *m_camCtl, m_materials};
-		m_scene.update(dt, ctx);
 
-		if (m_scene.entities.size() >= 2) {
-			m_scene.entities[0].transform.rotation = (float)m_time;
-			m_scene.entities[1].transform.y = 0.3f * std::sin((float)m_time * 2.0f);
+		// before the scene update, which applies the moved list to the spatial index
+		if (Transform* t = m_scene.registry.tryGet<Transform>(m_spinner)) {
+			t->rotation = (float)m_time;
+			m_scene.markMoved(m_spinner);
 		}
+		if (Transform* t = m_scene.registry.tryGet<Transform>(m_bobber)) {
+			t->y = 0.3f * std::sin((float)m_time * 2.0f);
+			m_scene.markMoved(m_bobber);
+		}
+
+		m_scene.update(dt, ctx);
 	}
 
 	void SandboxApp::render() {
+		m_textureLoader->update();
+
 		int fbW = m_window->framebufferWidth();
 		int fbH = m_window->framebufferHeight();
-		glViewport(0, 0, fbW, fbH);
+		glState().setViewport(0, 0, fbW, fbH);
 		m_renderer.clear(0.15f, 0.18f, 0.25f, 1.0f);
 		float aspect = (fbH != 0) ? (float)fbW / (float)fbH : 1.0f;
 
@@ -323,6 +563,9 @@ namespace argon {
 		m_frame2d.cam = &m_camera;
 		m_frame2d.aspect = aspect;
 		m_frame2d.PV = m_camera.projView(aspect);
+		m_frame2d.viewport = { 0.0f, 0.0f, (float)fbW, (float)fbH };
+		m_frame2d.time = (float)m_time;
+		m_frame2d.dt = m_frameDt;
 
 		m_pipeline2d.execute(m_frame2d, m_renderer);
 	}
@@ -339,6 +582,7 @@ namespace argon {
 
 		while (!m_window->shouldClose()) {
 
+			m_frameArena.beginFrame();
 			m_window->pollEvents();
 
 			double now = glfwGetTime();
@@ -374,6 +618,25 @@ namespace argon {
 					<< " vaoBinds=" << s.vaoBinds
 					<< " batchFlushes=" << s.batchFlushes
 					<< " batchedVerts=" << s.batchedVerts
+					<< " sortMs=" << s.sortMs
+					<< " cullMs=" << m_renderSys.stats().cullMs
+					<< " cullChunks=" << m_renderSys.stats().chunks
+					<< " cullIndexed=" << m_renderSys.stats().indexed
+					<< " worldUpdates=" << m_scene.worldStats().recomputed
+					<< " staticDraws=" << s.staticDraws
+					<< " staticSprites=" << s.staticSprites
+					<< " batchedMeshes=" << s.batchedMeshes
+					<< " batchFallbacks=" << s.batchFallbacks
+					<< " uniformLookups=" << m_spriteShader->uniformLookups()
+					<< " uniformUploads=" << s.uniformUploads
+					<< " uniformSkips=" << s.uniformSkips
+					<< " stateCalls=" << s.stateCalls
+					<< " stateSkips=" << s.stateSkips
+					<< " basicVariants=" << m_basicShaders->stats().variants
+					<< " recordMode=" << (m_pipeline2d.stats().mode == FrameMode::Record)
+					<< " arenaKB=" << m_frameArena.stats().used / 1024
+					<< " arenaPeakKB=" << m_frameArena.stats().peak / 1024
+					<< " arenaOverflows=" << m_frameArena.stats().overflows
 					<< "\n";
 
 				std::string title =
@@ -19,6 +19,9 @@
 #include "renderer/render_frame2d.h"
 #include "renderer/imgui_pass2d.h"
 #include "renderer/texture_atlas.h"
+#include "renderer/async_texture_loader.h"
+#include "core/frame_arena.h"
+#include "core/thread_pool.h"
 
 namespace argon {
 	class SandboxApp {
@@ -33,23 +36,31 @@ namespace argon {
 
 	private:
 		std::unique_ptr<Window> m_window;
+		std::unique_ptr<ThreadPool> m_jobs;
+		std::unique_ptr<AsyncTextureLoader> m_textureLoader;
 
-		std::unique_ptr<Shader> m_basicShader;
+		std::unique_ptr<ShaderPermutations> m_basicShaders;
 		std::unique_ptr<Shader> m_spriteShader;
+		std::unique_ptr<Shader> m_spriteCompactShader;
+		std::unique_ptr<Shader> m_spriteTrsShader;
+		std::unique_ptr<ShaderPermutations> m_meshBatchShaders;
 
 		std::unique_ptr<Mesh> m_tri;
 		std::unique_ptr<Mesh> m_quad;
 		std::unique_ptr<CameraController2D> m_camCtl;
-		std::unique_ptr<Texture2D> m_testTex;
+		Texture2D* m_testTex = nullptr; // owned by m_textureLoader
 		std::unique_ptr<Texture2D> m_atlasTex;
 
-		std::vector<std::unique_ptr<Texture2D>> m_textures;
+		std::vector<Texture2D*> m_textures; // owned by m_textureLoader
 
 		std::vector<MaterialHandle> m_matHandles;
 
+		FrameArena m_frameArena; // per-frame render data, started at the top of each loop
 		Renderer m_renderer;
 		Camera2D m_camera;
 		Scene m_scene;
+		EntityId m_spinner = kInvalidEntity; // first grid sprite, player controlled
+		EntityId m_bobber = kInvalidEntity;
 		InputMap m_input;
 		MovementSystem m_moveSys;
 		CameraSystem m_camSys;
@@ -65,6 +76,7 @@ namespace argon {
 
 		double m_lastTime = 0.0;
 		double m_time = 0.0;
+		float m_frameDt = 0.0f; // last update step, for the pass constants
 
 		float m_pulse = 0.0f;
 	};
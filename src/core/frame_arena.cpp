@@ -0,0 +1,86 @@
+#include "core/frame_arena.h"
+#include <algorithm>
+#include <new>
+
+namespace argon {
+
+	FrameArena::FrameArena(std::size_t bytesPerFrame) {
+		m_wanted = bytesPerFrame;
+		for (Buffer& b : m_buffers) reset(b);
+	}
+
+	FrameArena::~FrameArena() {
+		for (Buffer& b : m_buffers) {
+			for (const Overflow& o : b.overflow) ::operator delete(o.ptr, std::align_val_t(o.align));
+		}
+	}
+
+	void FrameArena::reset(Buffer& b) {
+		for (const Overflow& o : b.overflow) ::operator delete(o.ptr, std::align_val_t(o.align));
+		b.overflow.clear();
+
+		// the frame that just ended is the best guess for the next one, plus headroom
+		if (m_wanted > b.capacity) {
+			const std::size_t capacity = m_wanted + m_wanted / 4;
+			b.data.reset(new unsigned char[capacity]);
+			b.capacity = capacity;
+			if (m_frame > 0) m_grows++;
+		}
+		b.offset.store(0, std::memory_order_relaxed);
+		b.overflowBytes.store(0, std::memory_order_relaxed);
+	}
+
+	void FrameArena::beginFrame() {
+		const std::size_t used = stats().used;
+		m_peak = std::max(m_peak, used);
+		m_wanted = std::max(m_wanted, used);
+
+		m_current = (m_current == &m_buffers[0]) ? &m_buffers[1] : &m_buffers[0];
+		reset(*m_current);
+		m_frame++;
+	}
+
+	void FrameArena::reserve(std::size_t bytesPerFrame) {
+		m_wanted = std::max(m_wanted, bytesPerFrame);
+	}
+
+	void* FrameArena::allocate(std::size_t bytes, std::size_t align) {
+		if (bytes == 0) bytes = 1;
+		if (align == 0) align = alignof(std::max_align_t);
+		Buffer& b = *m_current;
+
+		if (b.data) {
+			const std::uintptr_t base = (std::uintptr_t)b.data.get();
+			std::size_t off = b.offset.load(std::memory_order_relaxed);
+			for (;;) {
+				const std::uintptr_t p = (base + off + (align - 1)) & ~(std::uintptr_t)(align - 1);
+				const std::size_t end = (std::size_t)(p - base) + bytes;
+				if (end > b.capacity) break;
+				if (b.offset.compare_exchange_weak(off, end, std::memory_order_relaxed)) return (void*)p;
+			}
+		}
+
+		// does not fit: heap block, freed when this buffer is reset
+		void* ptr = ::operator new(bytes, std::align_val_t(align));
+		b.overflowBytes.fetch_add(bytes, std::memory_order_relaxed);
+		std::lock_guard<std::mutex> lock(m_overflowMutex);
+		b.overflow.push_back({ ptr, align });
+		return ptr;
+	}
+
+	FrameArena::Stats FrameArena::stats() const {
+		const Buffer& b = *m_current;
+		Stats s;
+		s.capacity = b.capacity;
+		s.overflowBytes = b.overflowBytes.load(std::memory_order_relaxed);
+		s.used = b.offset.load(std::memory_order_relaxed) + s.overflowBytes;
+		s.peak = std::max(m_peak, s.used);
+		{
+			std::lock_guard<std::mutex> lock(m_overflowMutex);
+			s.overflows = (std::uint32_t)b.overflow.size();
+		}
+		s.grows = m_grows;
+		s.frame = m_frame;
+		return s;
+	}
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace argon {
+
+	// Double-buffered bump allocator for data that lives for one frame.
+	// beginFrame() flips to the other buffer and resets it, so memory handed out
+	// in frame N stays valid through frame N+1 and is reused in frame N+2.
+	// Nothing is freed individually.
+	//
+	// allocate() is lock-free and safe from several threads. A request that does
+	// not fit is served from the heap and counted as overflow; the buffer then
+	// grows to the frame's total the next time it is reset, so steady-state
+	// frames never reach the general heap.
+	class FrameArena {
+	public:
+		struct Stats {
+			std::size_t capacity = 0;     // bytes per buffer
+			std::size_t used = 0;         // this frame, overflow included
+			std::size_t peak = 0;         // largest frame since resetPeak()
+			std::uint32_t overflows = 0;  // heap fallbacks this frame
+			std::size_t overflowBytes = 0;
+			std::uint32_t grows = 0;      // buffer reallocations since construction
+			std::uint64_t frame = 0;
+		};
+
+		explicit FrameArena(std::size_t bytesPerFrame = 4u << 20);
+		~FrameArena();
+
+		FrameArena(const FrameArena&) = delete;
+		FrameArena& operator=(const FrameArena&) = delete;
+
+		void beginFrame();
+		// frames started so far; containers compare it to know when to rebind
+		std::uint64_t frame() const { return m_frame; }
+
+		void* allocate(std::size_t bytes, std::size_t align);
+
+		template<class T>
+		T* allocArray(std::size_t n) {
+			static_assert(std::is_trivially_destructible<T>::value, "arena memory is never destroyed");
+			return static_cast<T*>(allocate(n * sizeof(T), alignof(T)));
+		}
+
+		// grows both buffers at their next reset
+		void reserve(std::size_t bytesPerFrame);
+
+		Stats stats() const;
+		void resetPeak() { m_peak = 0; }
+
+	private:
+		struct Overflow {
+			void* ptr = nullptr;
+			std::size_t align = 0;
+		};
+
+		struct Buffer {
+			std::unique_ptr<unsigned char[]> data;
+			std::size_t capacity = 0;
+			std::atomic<std::size_t> offset{ 0 };
+			std::atomic<std::size_t> overflowBytes{ 0 };
+			std::vector<Overflow> overflow; // guarded by m_overflowMutex
+		};
+
+		void reset(Buffer& b);
+
+	private:
+		Buffer m_buffers[2];
+		Buffer* m_current = &m_buffers[0];
+		std::size_t m_wanted = 0;
+		std::size_t m_peak = 0;
+		std::uint32_t m_grows = 0;
+		std::uint64_t m_frame = 0;
+		mutable std::mutex m_overflowMutex;
+	};
+
+	// std allocator over a FrameArena; a null arena means the ordinary heap.
+	// deallocate() is a no-op for arena memory, so a container that grows
+	// leaves its old block behind until the buffer is reset.
+	template<class T>
+	class FrameAllocator {
+	public:
+		using value_type = T;
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+
+		FrameAllocator(FrameArena* arena = nullptr) noexcept : m_arena(arena) {}
+		template<class U>
+		FrameAllocator(const FrameAllocator<U>& o) noexcept : m_arena(o.arena()) {}
+
+		T* allocate(std::size_t n) {
+			if (m_arena) return static_cast<T*>(m_arena->allocate(n * sizeof(T), alignof(T)));
+			return std::allocator<T>().allocate(n);
+		}
+
+		void deallocate(T* p, std::size_t n) noexcept {
+			if (!m_arena) std::allocator<T>().deallocate(p, n);
+		}
+
+		FrameArena* arena() const { return m_arena; }
+
+		template<class U>
+		bool operator==(const FrameAllocator<U>& o) const { return m_arena == o.arena(); }
+		template<class U>
+		bool operator!=(const FrameAllocator<U>& o) const { return m_arena != o.arena(); }
+
+	private:
+		FrameArena* m_arena = nullptr;
+	};
+
+	template<class T>
+	using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+	// Moves v onto arena's current frame with last frame's capacity reserved.
+	// The old contents are dropped, never read: they may sit in a buffer that
+	// was already reset.
+	template<class T>
+	void rebindFrameVector(FrameVector<T>& v, FrameArena* arena) {
+		static_assert(std::is_trivially_destructible<T>::value, "arena memory is never destroyed");
+		const std::size_t keep = v.capacity();
+		v = FrameVector<T>(FrameAllocator<T>(arena));
+		v.reserve(keep);
+	}
+}
@@ -0,0 +1,110 @@
+#include "core/thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace argon {
+
+	ThreadPool::ThreadPool(unsigned workerCount) {
+		if (workerCount == 0) {
+			const unsigned hw = std::thread::hardware_concurrency();
+			workerCount = hw > 1 ? hw - 1 : 1;
+		}
+		m_workers.reserve(workerCount);
+		for (unsigned i = 0; i < workerCount; ++i) {
+			m_workers.emplace_back([this] { workerLoop(); });
+		}
+	}
+
+	ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_cv.notify_all();
+		for (auto& t : m_workers) {
+			if (t.joinable()) t.join();
+		}
+	}
+
+	void ThreadPool::submit(std::function<void()> job) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_jobs.push_back(std::move(job));
+		}
+		m_cv.notify_one();
+	}
+
+	void ThreadPool::workerLoop() {
+		for (;;) {
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_cv.wait(lock, [this] { return m_stop || !m_jobs.empty(); });
+				if (m_stop && m_jobs.empty()) return;
+				job = std::move(m_jobs.front());
+				m_jobs.pop_front();
+			}
+			job();
+		}
+	}
+
+	std::size_t ThreadPool::chunkCount(std::size_t count, std::size_t minChunk) const {
+		if (count == 0) return 0;
+		minChunk = std::max<std::size_t>(minChunk, 1);
+		const std::size_t maxChunks = m_workers.size() + 1;
+		const std::size_t byWork = (count + minChunk - 1) / minChunk;
+		return std::min(maxChunks, byWork);
+	}
+
+	namespace {
+		// shared with the helper jobs, which may still sit in the queue after
+		// parallelFor returned; by then they find no chunk left and touch nothing else
+		struct ParallelForState {
+			const std::function<void(std::size_t, std::size_t, std::size_t)>* fn = nullptr;
+			std::size_t chunks = 0, per = 0, rem = 0;
+			std::atomic<std::size_t> next{ 0 };
+			std::mutex doneMutex;
+			std::condition_variable doneCv;
+			std::size_t done = 0;
+
+			std::size_t chunkBegin(std::size_t c) const { return c * per + std::min(c, rem); }
+
+			// claims chunks until none is left
+			void run() {
+				for (;;) {
+					const std::size_t c = next.fetch_add(1, std::memory_order_relaxed);
+					if (c >= chunks) return;
+					(*fn)(chunkBegin(c), chunkBegin(c + 1), c);
+					std::lock_guard<std::mutex> lock(doneMutex);
+					if (++done == chunks) doneCv.notify_one();
+				}
+			}
+		};
+	}
+
+	void ThreadPool::parallelFor(std::size_t count, std::size_t minChunk,
+								 const std::function<void(std::size_t, std::size_t, std::size_t)>& fn) {
+		const std::size_t chunks = chunkCount(count, minChunk);
+		if (chunks == 0) return;
+		if (chunks == 1) { fn(0, count, 0); return; }
+
+		auto state = std::make_shared<ParallelForState>();
+		state->fn = &fn;
+		state->chunks = chunks;
+		state->per = count / chunks;
+		state->rem = count % chunks;
+
+		for (std::size_t c = 1; c < chunks; ++c) {
+			submit([state] { state->run(); });
+		}
+
+		// the caller works through whatever no worker has claimed yet, so chunks
+		// queued behind long jobs (or on a busy pool, when called from a worker)
+		// never hold it up; it only waits for chunks already running elsewhere
+		state->run();
+
+		std::unique_lock<std::mutex> lock(state->doneMutex);
+		state->doneCv.wait(lock, [&] { return state->done == chunks; });
+	}
+}
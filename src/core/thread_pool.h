@@ -0,0 +1,47 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace argon {
+
+	class ThreadPool {
+	public:
+		// workerCount = 0 => hardware_concurrency - 1 (the caller is the extra worker)
+		explicit ThreadPool(unsigned workerCount = 0);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		unsigned workerCount() const { return (unsigned)m_workers.size(); }
+
+		// fire and forget
+		void submit(std::function<void()> job);
+
+		// Split [0,count) into at most workerCount()+1 chunks of >= minChunk items,
+		// run fn(begin, end, chunkIndex) for each and block until all are done.
+		// Chunks are claimed in order by the calling thread and idle workers; the
+		// caller runs every chunk nobody else picked up, so queued jobs ahead of
+		// the helpers cannot stall it. Safe to call from a worker.
+		void parallelFor(std::size_t count, std::size_t minChunk,
+						 const std::function<void(std::size_t, std::size_t, std::size_t)>& fn);
+
+		// number of chunks parallelFor will use for this count
+		std::size_t chunkCount(std::size_t count, std::size_t minChunk) const;
+
+	private:
+		void workerLoop();
+
+	private:
+		std::vector<std::thread> m_workers;
+		std::deque<std::function<void()>> m_jobs;
+		std::mutex m_mutex;
+		std::condition_variable m_cv;
+		bool m_stop = false;
+	};
+}
@@ -1,5 +1,6 @@
 #pragma once
-#include "math/mat4.h"
+#include "math/affine2d.h"
+#include "math/aabb_cull.h"
 
 namespace argon {
 	
@@ -12,6 +13,22 @@ namespace argon {
 
 		float size = 1.0f;
 
+		// 2D parts of the camera; the Mat4 versions below wrap them for shaders
+		Affine2D projectionAffine(float aspect) const {
+			const float halfH = size / zoom;
+			const float halfW = size * aspect / zoom;
+			return Affine2D::scale(1.0f / halfW, 1.0f / halfH);
+		}
+
+		// inverse of translate(x, y) * rotate(rotation)
+		Affine2D viewAffine() const {
+			return mul(Affine2D::rotate(-rotation), Affine2D::translate(-x, -y));
+		}
+
+		Affine2D projViewAffine(float aspect) const {
+			return mul(projectionAffine(aspect), viewAffine());
+		}
+
 		Mat4 projection(float aspect) const {
 			float halfH = size / zoom;
 			float halfW = size * aspect /zoom;
@@ -19,14 +36,23 @@ namespace argon {
 		}
 
 		Mat4 view() const {
-			Mat4 Tinv = Mat4::translate(-x, -y, 0.0f);
-			Mat4 Rinv = Mat4::rotateZ(-rotation);
-
-			return mul(Rinv, Tinv);
+			return viewAffine().toMat4();
 		}
 
 		Mat4 projView(float aspect) const {
-			return mul(projection(aspect), view());
+			Mat4 r = projViewAffine(aspect).toMat4();
+			r.m[10] = -1.0f; // z row of Mat4::ortho(.., -1, 1)
+			return r;
+		}
+
+		// visible world area; rotated with the camera
+		OrientedRect viewRect(float aspect) const {
+			return { x, y, size * aspect / zoom, size / zoom, rotation };
+		}
+
+		// axis-aligned world bounds of viewRect, conservative when rotated
+		CullRect viewBounds(float aspect) const {
+			return boundsOf(viewRect(aspect));
 		}
 
 	private:
@@ -0,0 +1,163 @@
+#include "math/aabb_cull.h"
+
+// SSE2 is only assumed where it is part of the baseline ABI
+#if defined(__x86_64__) || defined(_M_X64)
+#define ARGON_CULL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#else
+#define ARGON_CULL_X86 0
+#endif
+
+// the AVX2 kernel is compiled for AVX2 regardless of the global flags and only
+// called after the runtime check
+#if ARGON_CULL_X86 && (defined(__GNUC__) || defined(__clang__))
+#define ARGON_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define ARGON_TARGET_AVX2
+#endif
+
+namespace argon {
+
+	static std::size_t cullScalar(const AabbArrays& b, std::size_t begin, std::size_t end,
+								  const CullRect& r, std::uint32_t* out) {
+		std::size_t n = 0;
+		for (std::size_t i = begin; i < end; ++i) {
+			// branchless: always store, advance only when visible
+			const bool hit = (b.minX[i] <= r.maxX) & (b.maxX[i] >= r.minX) &
+							 (b.minY[i] <= r.maxY) & (b.maxY[i] >= r.minY);
+			out[n] = (std::uint32_t)i;
+			n += hit ? 1 : 0;
+		}
+		return n;
+	}
+
+#if ARGON_CULL_X86
+	static inline int countTrailingZeros(unsigned mask) {
+#if defined(_MSC_VER)
+		unsigned long idx;
+		_BitScanForward(&idx, mask);
+		return (int)idx;
+#else
+		return __builtin_ctz(mask);
+#endif
+	}
+
+	static inline std::size_t emitMask(unsigned mask, std::size_t base, std::uint32_t* out, std::size_t n) {
+		while (mask) {
+			out[n++] = (std::uint32_t)(base + countTrailingZeros(mask));
+			mask &= mask - 1;
+		}
+		return n;
+	}
+
+	static std::size_t cullSSE2(const AabbArrays& b, std::size_t begin, std::size_t end,
+								const CullRect& r, std::uint32_t* out) {
+		const __m128 rMinX = _mm_set1_ps(r.minX);
+		const __m128 rMinY = _mm_set1_ps(r.minY);
+		const __m128 rMaxX = _mm_set1_ps(r.maxX);
+		const __m128 rMaxY = _mm_set1_ps(r.maxY);
+
+		std::size_t n = 0;
+		std::size_t i = begin;
+		for (; i + 4 <= end; i += 4) {
+			const __m128 a = _mm_cmple_ps(_mm_loadu_ps(b.minX + i), rMaxX);
+			const __m128 c = _mm_cmpge_ps(_mm_loadu_ps(b.maxX + i), rMinX);
+			const __m128 d = _mm_cmple_ps(_mm_loadu_ps(b.minY + i), rMaxY);
+			const __m128 e = _mm_cmpge_ps(_mm_loadu_ps(b.maxY + i), rMinY);
+			const unsigned mask = (unsigned)_mm_movemask_ps(_mm_and_ps(_mm_and_ps(a, c), _mm_and_ps(d, e)));
+			n = emitMask(mask, i, out, n);
+		}
+		return n + cullScalar(b, i, end, r, out + n);
+	}
+
+	ARGON_TARGET_AVX2
+	static std::size_t cullAVX2(const AabbArrays& b, std::size_t begin, std::size_t end,
+								const CullRect& r, std::uint32_t* out) {
+		const __m256 rMinX = _mm256_set1_ps(r.minX);
+		const __m256 rMinY = _mm256_set1_ps(r.minY);
+		const __m256 rMaxX = _mm256_set1_ps(r.maxX);
+		const __m256 rMaxY = _mm256_set1_ps(r.maxY);
+
+		std::size_t n = 0;
+		std::size_t i = begin;
+		for (; i + 8 <= end; i += 8) {
+			const __m256 a = _mm256_cmp_ps(_mm256_loadu_ps(b.minX + i), rMaxX, _CMP_LE_OQ);
+			const __m256 c = _mm256_cmp_ps(_mm256_loadu_ps(b.maxX + i), rMinX, _CMP_GE_OQ);
+			const __m256 d = _mm256_cmp_ps(_mm256_loadu_ps(b.minY + i), rMaxY, _CMP_LE_OQ);
+			const __m256 e = _mm256_cmp_ps(_mm256_loadu_ps(b.maxY + i), rMinY, _CMP_GE_OQ);
+			const unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_and_ps(_mm256_and_ps(a, c), _mm256_and_ps(d, e)));
+			n = emitMask(mask, i, out, n);
+		}
+		return n + cullScalar(b, i, end, r, out + n);
+	}
+
+	static bool cpuHasAVX2() {
+#if defined(_MSC_VER)
+		int regs[4];
+		__cpuid(regs, 0);
+		if (regs[0] < 7) return false;
+		__cpuid(regs, 1);
+		const bool osxsave = (regs[2] & (1 << 27)) != 0;
+		const bool avx = (regs[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx) return false;
+		// the OS must save the YMM registers
+		if ((_xgetbv(0) & 0x6) != 0x6) return false;
+		__cpuidex(regs, 7, 0);
+		return (regs[1] & (1 << 5)) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+#endif
+
+	bool cullKernelSupported(CullKernel kernel) {
+		switch (kernel) {
+		case CullKernel::Scalar: return true;
+#if ARGON_CULL_X86
+		case CullKernel::SSE2: return true; // x86-64 baseline
+		case CullKernel::AVX2: {
+			static const bool avx2 = cpuHasAVX2();
+			return avx2;
+		}
+#endif
+		default: return false;
+		}
+	}
+
+	CullKernel bestCullKernel() {
+		static const CullKernel best =
+			cullKernelSupported(CullKernel::AVX2) ? CullKernel::AVX2 :
+			cullKernelSupported(CullKernel::SSE2) ? CullKernel::SSE2 : CullKernel::Scalar;
+		return best;
+	}
+
+	const char* cullKernelName(CullKernel kernel) {
+		switch (kernel) {
+		case CullKernel::Scalar: return "scalar";
+		case CullKernel::SSE2: return "sse2";
+		case CullKernel::AVX2: return "avx2";
+		}
+		return "?";
+	}
+
+	std::size_t cullAabbsWith(CullKernel kernel, const AabbArrays& boxes, std::size_t begin, std::size_t end,
+							  const CullRect& rect, std::uint32_t* outIndices) {
+		if (begin >= end) return 0;
+		if (!cullKernelSupported(kernel)) kernel = CullKernel::Scalar;
+		switch (kernel) {
+#if ARGON_CULL_X86
+		case CullKernel::AVX2: return cullAVX2(boxes, begin, end, rect, outIndices);
+		case CullKernel::SSE2: return cullSSE2(boxes, begin, end, rect, outIndices);
+#endif
+		default: return cullScalar(boxes, begin, end, rect, outIndices);
+		}
+	}
+
+	std::size_t cullAabbs(const AabbArrays& boxes, std::size_t begin, std::size_t end,
+						  const CullRect& rect, std::uint32_t* outIndices) {
+		return cullAabbsWith(bestCullKernel(), boxes, begin, end, rect, outIndices);
+	}
+}
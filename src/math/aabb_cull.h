@@ -0,0 +1,79 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace argon {
+
+	// axis-aligned rect, inclusive edges
+	struct CullRect {
+		float minX = 0.0f, minY = 0.0f, maxX = 0.0f, maxY = 0.0f;
+	};
+
+	inline bool overlaps(const CullRect& a, const CullRect& b) {
+		return a.minX <= b.maxX && a.maxX >= b.minX && a.minY <= b.maxY && a.maxY >= b.minY;
+	}
+
+	// rect rotated by rotation radians around its center, e.g. a rotated camera view
+	struct OrientedRect {
+		float cx = 0.0f, cy = 0.0f;
+		float halfW = 0.0f, halfH = 0.0f;
+		float rotation = 0.0f;
+	};
+
+	// axis-aligned bounds of the rotated rect
+	inline CullRect boundsOf(const OrientedRect& o) {
+		const float c = std::abs(std::cos(o.rotation));
+		const float s = std::abs(std::sin(o.rotation));
+		const float ex = c * o.halfW + s * o.halfH;
+		const float ey = s * o.halfW + c * o.halfH;
+		return { o.cx - ex, o.cy - ey, o.cx + ex, o.cy + ey };
+	}
+
+	// exact separating-axis test; the world axes are covered by boundsOf(o)
+	inline bool overlaps(const OrientedRect& o, const CullRect& r) {
+		if (!overlaps(boundsOf(o), r)) return false;
+
+		const float c = std::cos(o.rotation);
+		const float s = std::sin(o.rotation);
+		const float hx = 0.5f * (r.maxX - r.minX);
+		const float hy = 0.5f * (r.maxY - r.minY);
+		const float dx = 0.5f * (r.minX + r.maxX) - o.cx;
+		const float dy = 0.5f * (r.minY + r.maxY) - o.cy;
+
+		// rect axes u = (c, s), v = (-s, c)
+		if (std::abs(dx * c + dy * s) > o.halfW + hx * std::abs(c) + hy * std::abs(s)) return false;
+		if (std::abs(-dx * s + dy * c) > o.halfH + hx * std::abs(s) + hy * std::abs(c)) return false;
+		return true;
+	}
+
+	// Bounds in structure-of-arrays form, one float per entity per array.
+	// A box with minX = +inf never passes (use it to mask out slots).
+	struct AabbArrays {
+		const float* minX = nullptr;
+		const float* minY = nullptr;
+		const float* maxX = nullptr;
+		const float* maxY = nullptr;
+	};
+
+	enum class CullKernel {
+		Scalar = 0,
+		SSE2,  // 4 boxes per compare
+		AVX2,  // 8 boxes per compare
+	};
+
+	// best kernel this CPU runs, detected once
+	CullKernel bestCullKernel();
+	bool cullKernelSupported(CullKernel kernel);
+	const char* cullKernelName(CullKernel kernel);
+
+	// Writes begin + i for every box i in [begin, end) that overlaps rect into
+	// outIndices, in ascending order, and returns how many were written.
+	// outIndices must have room for end - begin entries.
+	std::size_t cullAabbs(const AabbArrays& boxes, std::size_t begin, std::size_t end,
+						  const CullRect& rect, std::uint32_t* outIndices);
+
+	// same, forcing one kernel (falls back to Scalar when unsupported)
+	std::size_t cullAabbsWith(CullKernel kernel, const AabbArrays& boxes, std::size_t begin, std::size_t end,
+							  const CullRect& rect, std::uint32_t* outIndices);
+}
@@ -0,0 +1,110 @@
+#pragma once
+#include <cmath>
+#include "math/mat4.h"
+
+namespace argon {
+
+	// 2x3 affine transform, column-major like Mat4:
+	//   | a c tx |
+	//   | b d ty |
+	// (a, b) is the image of the x axis, (c, d) of the y axis.
+	// 24 bytes and 12 multiply-adds per product; convert with toMat4() only
+	// where a 4x4 is handed to the GPU.
+	struct Affine2D {
+		float a = 1.0f, b = 0.0f;
+		float c = 0.0f, d = 1.0f;
+		float tx = 0.0f, ty = 0.0f;
+
+		static Affine2D identity() { return {}; }
+
+		static Affine2D translate(float x, float y) {
+			Affine2D r;
+			r.tx = x; r.ty = y;
+			return r;
+		}
+
+		static Affine2D scale(float sx, float sy) {
+			Affine2D r;
+			r.a = sx; r.d = sy;
+			return r;
+		}
+
+		static Affine2D rotate(float radians) {
+			const float cs = std::cos(radians);
+			const float sn = std::sin(radians);
+			Affine2D r;
+			r.a = cs; r.b = sn;
+			r.c = -sn; r.d = cs;
+			return r;
+		}
+
+		// translate * rotate * scale, one sin/cos pair and no products
+		static Affine2D trs(float x, float y, float radians, float sx, float sy) {
+			const float cs = std::cos(radians);
+			const float sn = std::sin(radians);
+			Affine2D r;
+			r.a = cs * sx;  r.b = sn * sx;
+			r.c = -sn * sy; r.d = cs * sy;
+			r.tx = x; r.ty = y;
+			return r;
+		}
+
+		float determinant() const { return a * d - b * c; }
+
+		// singular transforms return identity
+		Affine2D inverse() const {
+			const float det = determinant();
+			if (det == 0.0f) return {};
+			const float inv = 1.0f / det;
+			Affine2D r;
+			r.a = d * inv;  r.b = -b * inv;
+			r.c = -c * inv; r.d = a * inv;
+			r.tx = -(r.a * tx + r.c * ty);
+			r.ty = -(r.b * tx + r.d * ty);
+			return r;
+		}
+
+		void transformPoint(float x, float y, float& outX, float& outY) const {
+			outX = a * x + c * y + tx;
+			outY = b * x + d * y + ty;
+		}
+
+		void transformVector(float x, float y, float& outX, float& outY) const {
+			outX = a * x + c * y;
+			outY = b * x + d * y;
+		}
+
+		// z passes through unchanged
+		Mat4 toMat4() const {
+			Mat4 r = Mat4::identity();
+			r.m[0] = a;  r.m[1] = b;
+			r.m[4] = c;  r.m[5] = d;
+			r.m[12] = tx; r.m[13] = ty;
+			return r;
+		}
+	};
+
+	// R = A * B (B applied first)
+	inline Affine2D mul(const Affine2D& A, const Affine2D& B) {
+		Affine2D R;
+		R.a = A.a * B.a + A.c * B.b;
+		R.b = A.b * B.a + A.d * B.b;
+		R.c = A.a * B.c + A.c * B.d;
+		R.d = A.b * B.c + A.d * B.d;
+		R.tx = A.a * B.tx + A.c * B.ty + A.tx;
+		R.ty = A.b * B.tx + A.d * B.ty + A.ty;
+		return R;
+	}
+
+	// A * B.toMat4() without the zero terms
+	inline Mat4 mul(const Mat4& A, const Affine2D& B) {
+		Mat4 R;
+		for (int row = 0; row < 4; ++row) {
+			R.m[0 + row] = A.m[row] * B.a + A.m[4 + row] * B.b;
+			R.m[4 + row] = A.m[row] * B.c + A.m[4 + row] * B.d;
+			R.m[8 + row] = A.m[8 + row];
+			R.m[12 + row] = A.m[row] * B.tx + A.m[4 + row] * B.ty + A.m[12 + row];
+		}
+		return R;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+namespace argon {
+
+	// IEEE 754 binary16 from float, round to nearest even.
+	// Overflow goes to inf, NaN stays NaN, tiny values flush through denormals.
+	inline std::uint16_t floatToHalf(float f) {
+		std::uint32_t x;
+		std::memcpy(&x, &f, sizeof(x));
+
+		const std::uint32_t sign = (x >> 16) & 0x8000u;
+		const std::uint32_t absx = x & 0x7FFFFFFFu;
+
+		if (absx >= 0x7F800000u) // inf / nan
+			return (std::uint16_t)(sign | 0x7C00u | (absx > 0x7F800000u ? 0x200u : 0u));
+		if (absx >= 0x477FF000u) // rounds past 65504
+			return (std::uint16_t)(sign | 0x7C00u);
+		if (absx < 0x38800000u) { // below the smallest normal half: denormal or zero
+			if (absx < 0x33000000u) return (std::uint16_t)sign;
+			const std::uint32_t mant = (absx & 0x007FFFFFu) | 0x00800000u;
+			const int shift = 113 - (int)(absx >> 23) + 13;
+			std::uint32_t h = mant >> shift;
+			const std::uint32_t rem = mant & ((1u << shift) - 1u);
+			const std::uint32_t halfway = 1u << (shift - 1);
+			if (rem > halfway || (rem == halfway && (h & 1u))) h++;
+			return (std::uint16_t)(sign | h);
+		}
+
+		std::uint32_t h = ((absx - 0x38000000u) >> 13);
+		const std::uint32_t rem = absx & 0x1FFFu;
+		if (rem > 0x1000u || (rem == 0x1000u && (h & 1u))) h++;
+		return (std::uint16_t)(sign | h);
+	}
+
+	// clamp to [0,1] and quantize to an unsigned normalized integer
+	inline std::uint8_t unorm8(float v) {
+		v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+		return (std::uint8_t)(v * 255.0f + 0.5f);
+	}
+
+	inline std::uint16_t unorm16(float v) {
+		v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+		return (std::uint16_t)(v * 65535.0f + 0.5f);
+	}
+}
@@ -1,6 +1,14 @@
 #pragma once
 #include <cmath>
 
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define ARGON_MAT4_SSE 1
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define ARGON_MAT4_NEON 1
+#include <arm_neon.h>
+#endif
+
 namespace argon {
 
 	struct Mat4 {
@@ -53,7 +61,8 @@ namespace argon {
 		}
 	};
 
-	inline Mat4 mul(const Mat4& A, const Mat4& B) {
+	// reference version, also the fallback without SSE/NEON
+	inline Mat4 mulScalar(const Mat4& A, const Mat4& B) {
 		Mat4 R{};
 		// R = A * B, column matrix
 		for (int col = 0; col < 4; ++col) {
@@ -68,4 +77,41 @@ namespace argon {
 		return R;
 	}
 
+	// column j of R = sum_k column k of A * B[j][k], four rows per vector op
+	inline Mat4 mul(const Mat4& A, const Mat4& B) {
+#if defined(ARGON_MAT4_SSE)
+		const __m128 a0 = _mm_loadu_ps(A.m + 0);
+		const __m128 a1 = _mm_loadu_ps(A.m + 4);
+		const __m128 a2 = _mm_loadu_ps(A.m + 8);
+		const __m128 a3 = _mm_loadu_ps(A.m + 12);
+		Mat4 R;
+		for (int col = 0; col < 4; ++col) {
+			const float* b = B.m + col * 4;
+			__m128 r = _mm_mul_ps(a0, _mm_set1_ps(b[0]));
+			r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(b[1])));
+			r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(b[2])));
+			r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(b[3])));
+			_mm_storeu_ps(R.m + col * 4, r);
+		}
+		return R;
+#elif defined(ARGON_MAT4_NEON)
+		const float32x4_t a0 = vld1q_f32(A.m + 0);
+		const float32x4_t a1 = vld1q_f32(A.m + 4);
+		const float32x4_t a2 = vld1q_f32(A.m + 8);
+		const float32x4_t a3 = vld1q_f32(A.m + 12);
+		Mat4 R;
+		for (int col = 0; col < 4; ++col) {
+			const float* b = B.m + col * 4;
+			float32x4_t r = vmulq_n_f32(a0, b[0]);
+			r = vmlaq_n_f32(r, a1, b[1]);
+			r = vmlaq_n_f32(r, a2, b[2]);
+			r = vmlaq_n_f32(r, a3, b[3]);
+			vst1q_f32(R.m + col * 4, r);
+		}
+		return R;
+#else
+		return mulScalar(A, B);
+#endif
+	}
+
 }
\ No newline at end of file
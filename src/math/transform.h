@@ -1,5 +1,5 @@
 #pragma once
-#include "mat4.h"
+#include "math/affine2d.h"
 
 namespace argon {
 	struct Transform {
@@ -9,11 +9,24 @@ namespace argon {
 		float sx = 1.0f;
 		float sy = 1.0f;
 
+		// T * R * S
+		Affine2D affine() const {
+			return Affine2D::trs(x, y, rotation, sx, sy);
+		}
+
 		Mat4 matrix() const {
-			Mat4 T = Mat4::translate(x, y, 0.0f);
-			Mat4 R = Mat4::rotateZ(rotation);
-			Mat4 S = Mat4::scale(sx, sy, 1.0f);
-			return mul(T, mul(R, S));
+			return affine().toMat4();
+		}
+
+		// inverse of affine(); skew cannot be represented and is dropped
+		static Transform fromAffine(const Affine2D& m) {
+			Transform t;
+			t.x = m.tx;
+			t.y = m.ty;
+			t.sx = std::sqrt(m.a * m.a + m.b * m.b);
+			t.rotation = std::atan2(m.b, m.a);
+			t.sy = t.sx != 0.0f ? m.determinant() / t.sx : std::sqrt(m.c * m.c + m.d * m.d);
+			return t;
 		}
 	};
 }
\ No newline at end of file
@@ -0,0 +1,110 @@
+#include "platform/mapped_file.h"
+#include <utility>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace argon {
+
+	MappedFile::~MappedFile() {
+		close();
+	}
+
+	MappedFile::MappedFile(MappedFile&& o) noexcept {
+		*this = std::move(o);
+	}
+
+	MappedFile& MappedFile::operator=(MappedFile&& o) noexcept {
+		if (this == &o) return *this;
+		close();
+		std::swap(m_data, o.m_data);
+		std::swap(m_size, o.m_size);
+#ifdef _WIN32
+		std::swap(m_file, o.m_file);
+		std::swap(m_mapping, o.m_mapping);
+#endif
+		return *this;
+	}
+
+#ifdef _WIN32
+	bool MappedFile::open(const std::string& path) {
+		close();
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+								  OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) return false;
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (!mapping) {
+			CloseHandle(file);
+			return false;
+		}
+
+		void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (!view) {
+			CloseHandle(mapping);
+			CloseHandle(file);
+			return false;
+		}
+
+		m_file = file;
+		m_mapping = mapping;
+		m_data = (const std::uint8_t*)view;
+		m_size = (std::size_t)size.QuadPart;
+		return true;
+	}
+
+	void MappedFile::close() {
+		if (m_data) UnmapViewOfFile(m_data);
+		if (m_mapping) CloseHandle((HANDLE)m_mapping);
+		if (m_file) CloseHandle((HANDLE)m_file);
+		m_data = nullptr;
+		m_mapping = nullptr;
+		m_file = nullptr;
+		m_size = 0;
+	}
+#else
+	bool MappedFile::open(const std::string& path) {
+		close();
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+
+		struct stat st {};
+		if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+			::close(fd);
+			return false;
+		}
+
+		void* view = mmap(nullptr, (std::size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd); // the mapping keeps the file alive
+		if (view == MAP_FAILED) return false;
+
+		m_data = (const std::uint8_t*)view;
+		m_size = (std::size_t)st.st_size;
+		return true;
+	}
+
+	void MappedFile::close() {
+		if (m_data) munmap((void*)m_data, m_size);
+		m_data = nullptr;
+		m_size = 0;
+	}
+#endif
+}
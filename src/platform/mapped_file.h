@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace argon {
+
+	// Read-only memory mapping of a whole file.
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		MappedFile(MappedFile&& o) noexcept;
+		MappedFile& operator=(MappedFile&& o) noexcept;
+
+		bool open(const std::string& path);
+		void close();
+
+		bool isOpen() const { return m_data != nullptr; }
+		const std::uint8_t* data() const { return m_data; }
+		std::size_t size() const { return m_size; }
+
+	private:
+		const std::uint8_t* m_data = nullptr;
+		std::size_t m_size = 0;
+#ifdef _WIN32
+		void* m_file = nullptr;
+		void* m_mapping = nullptr;
+#endif
+	};
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+
+namespace argon {
+
+	// Cold-start cost of a single texture / atlas load, in milliseconds.
+	struct AssetLoadStats {
+		double ioMs = 0.0;       // read into memory, or map for cooked files
+		double decodeMs = 0.0;   // image decode / text parse, 0 for cooked files
+		double uploadMs = 0.0;   // glTexImage2D calls
+		std::uint64_t bytes = 0; // source bytes consumed
+		bool cooked = false;
+
+		double totalMs() const { return ioMs + decodeMs + uploadMs; }
+	};
+}
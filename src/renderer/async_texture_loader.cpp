@@ -0,0 +1,207 @@
+#include "renderer/async_texture_loader.h"
+#include "core/thread_pool.h"
+#include "renderer/gl_state_tracker.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace argon {
+
+	using LoadClock = std::chrono::steady_clock;
+
+	static double msSince(LoadClock::time_point t0) {
+		return std::chrono::duration<double, std::milli>(LoadClock::now() - t0).count();
+	}
+
+	AsyncTextureLoader::AsyncTextureLoader(ThreadPool& pool) : AsyncTextureLoader(pool, Settings{}) {}
+
+	AsyncTextureLoader::AsyncTextureLoader(ThreadPool& pool, const Settings& settings)
+		: m_pool(pool), m_settings(settings) {}
+
+	AsyncTextureLoader::~AsyncTextureLoader() {
+		for (auto& job : m_jobs) job->cancelled = true;
+		{
+			// jobs capture this, let the workers drain before members go away
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_idleCv.wait(lock, [this] { return m_inFlight == 0; });
+		}
+		for (auto& job : m_jobs) destroyStaging(*job);
+		glState().forgetBuffer(m_pbo);
+		if (m_pbo) glDeleteBuffers(1, &m_pbo);
+	}
+
+	Texture2D* AsyncTextureLoader::load(const std::string& path) {
+		for (auto& job : m_jobs) {
+			if (job->path == path) return job->texture.get();
+		}
+
+		auto job = std::make_shared<Job>();
+		job->path = path;
+		job->texture = std::make_unique<Texture2D>(1, 1, m_settings.placeholder);
+		m_jobs.push_back(job);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_inFlight++;
+		}
+		m_stats.decoding++;
+		m_pool.submit([this, job] { decode(job); });
+		return job->texture.get();
+	}
+
+	// worker thread
+	void AsyncTextureLoader::decode(const std::shared_ptr<Job>& job) {
+		if (!job->cancelled) {
+			auto t0 = LoadClock::now();
+			std::ifstream in(job->path, std::ios::binary);
+			std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+			job->loadStats.ioMs = msSince(t0);
+			job->loadStats.bytes = bytes.size();
+
+			t0 = LoadClock::now();
+			job->image = decodeImageRGBA(bytes.data(), bytes.size());
+			job->loadStats.decodeMs = msSince(t0);
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_decoded.push_back(job);
+		if (--m_inFlight == 0) m_idleCv.notify_all();
+	}
+
+	void AsyncTextureLoader::release(const Texture2D* texture) {
+		auto it = std::find_if(m_jobs.begin(), m_jobs.end(),
+							   [&](const std::shared_ptr<Job>& j) { return j->texture.get() == texture; });
+		if (it == m_jobs.end()) return;
+
+		// a worker or the upload queue may still hold the job; it is skipped there
+		(*it)->cancelled = true;
+		destroyStaging(**it);
+		(*it)->texture.reset();
+		m_jobs.erase(it);
+	}
+
+	bool AsyncTextureLoader::isReady(const Texture2D* texture) const {
+		for (const auto& job : m_jobs) {
+			if (job->texture.get() == texture) return job->state == State::Ready;
+		}
+		return false;
+	}
+
+	bool AsyncTextureLoader::idle() const {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_inFlight == 0 && m_decoded.empty() && m_uploadQueue.empty();
+	}
+
+	void AsyncTextureLoader::update() {
+		m_stats.uploadedBytes = 0;
+		m_stats.uploadMs = 0.0;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			while (!m_decoded.empty()) {
+				std::shared_ptr<Job> job = std::move(m_decoded.front());
+				m_decoded.pop_front();
+				m_stats.decoding--;
+				if (job->cancelled) continue;
+
+				if (!job->image.ok()) {
+					std::cerr << "Failed to load texture: " << job->path << "\n";
+					job->state = State::Failed;
+					m_stats.failed++;
+					continue;
+				}
+				job->state = State::Uploading;
+				m_stats.uploading++;
+				m_uploadQueue.push_back(std::move(job));
+			}
+		}
+
+		if (m_uploadQueue.empty()) return;
+
+		const auto t0 = LoadClock::now();
+		std::size_t budget = m_settings.uploadBudgetBytes;
+		while (!m_uploadQueue.empty() && budget > 0) {
+			Job& job = *m_uploadQueue.front();
+			if (!job.cancelled) {
+				budget -= std::min(budget, uploadBands(job, budget));
+				if (job.nextRow < job.image.height) break; // budget spent mid-image
+				finish(job);
+			}
+			m_uploadQueue.pop_front();
+			m_stats.uploading--;
+		}
+
+		glState().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glState().bindTexture(GL_TEXTURE_2D, 0);
+		m_stats.uploadMs = msSince(t0);
+	}
+
+	// Uploads whole rows from nextRow on; at least one row so a single row wider
+	// than the budget still makes progress. Returns the bytes uploaded.
+	std::size_t AsyncTextureLoader::uploadBands(Job& job, std::size_t budget) {
+		const DecodedImage& img = job.image;
+		const std::size_t rowBytes = img.rowBytes();
+		const int rows = std::min(img.height - job.nextRow, (int)std::max<std::size_t>(1, budget / rowBytes));
+		const std::size_t bytes = rowBytes * (std::size_t)rows;
+		const auto t0 = LoadClock::now();
+
+		if (!job.staging) {
+			glGenTextures(1, &job.staging);
+			glState().bindTexture(GL_TEXTURE_2D, job.staging);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			glState().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, img.width, img.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		} else {
+			glState().bindTexture(GL_TEXTURE_2D, job.staging);
+		}
+
+		if (!m_pbo) glGenBuffers(1, &m_pbo);
+		glState().bindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo);
+
+		// orphan every band: the driver hands out fresh storage instead of
+		// waiting for the previous glTexSubImage2D to consume the old one
+		m_pboBytes = std::max(m_pboBytes, bytes);
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)m_pboBytes, nullptr, GL_STREAM_DRAW);
+		void* dst = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)bytes,
+									 GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		if (!dst) {
+			// mapping failed (out of memory); fall back to a client-memory upload
+			glState().bindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, job.nextRow, img.width, rows, GL_RGBA, GL_UNSIGNED_BYTE,
+							img.pixels.get() + rowBytes * (std::size_t)job.nextRow);
+		} else {
+			std::memcpy(dst, img.pixels.get() + rowBytes * (std::size_t)job.nextRow, bytes);
+			glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, job.nextRow, img.width, rows, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		}
+
+		job.nextRow += rows;
+		job.loadStats.uploadMs += msSince(t0); // summed over the frames the bands were spread across
+		m_stats.uploadedBytes += bytes;
+		return bytes;
+	}
+
+	void AsyncTextureLoader::finish(Job& job) {
+		job.texture->adoptTexture(job.staging, job.image.width, job.image.height, job.loadStats);
+		job.staging = 0;
+		job.image = {};
+		job.state = State::Ready;
+		m_stats.completed++;
+	}
+
+	void AsyncTextureLoader::destroyStaging(Job& job) {
+		if (job.staging) {
+			glState().forgetTexture(job.staging);
+			glDeleteTextures(1, &job.staging);
+		}
+		job.staging = 0;
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <glad/glad.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "renderer/texture2d.h"
+#include "renderer/image_decode.h"
+
+namespace argon {
+
+	class ThreadPool;
+
+	// Decodes images on a ThreadPool and uploads them through a pixel unpack
+	// buffer on the GL thread, a few row bands per update() so no frame spends
+	// more than uploadBudgetBytes. load() returns at once with a 1x1 placeholder
+	// texture that adopts the real image when its last band is uploaded.
+	class AsyncTextureLoader {
+	public:
+		struct Settings {
+			std::size_t uploadBudgetBytes = 4u << 20; // per update()
+			std::uint8_t placeholder[4] = { 255, 0, 255, 255 };
+		};
+
+		struct Stats {
+			std::uint32_t decoding = 0;  // queued or running on a worker
+			std::uint32_t uploading = 0; // decoded, waiting for / in upload
+			std::uint32_t completed = 0;
+			std::uint32_t failed = 0;
+			std::uint64_t uploadedBytes = 0; // last update()
+			double uploadMs = 0.0;           // last update()
+		};
+
+		// GL thread only; the pool must outlive the loader
+		explicit AsyncTextureLoader(ThreadPool& pool);
+		AsyncTextureLoader(ThreadPool& pool, const Settings& settings);
+		~AsyncTextureLoader();
+
+		AsyncTextureLoader(const AsyncTextureLoader&) = delete;
+		AsyncTextureLoader& operator=(const AsyncTextureLoader&) = delete;
+
+		// The loader owns the texture; the pointer stays valid until release().
+		// Loading a path again returns the same texture.
+		Texture2D* load(const std::string& path);
+		void release(const Texture2D* texture);
+
+		bool isReady(const Texture2D* texture) const;
+		bool idle() const;
+
+		// once per frame on the GL thread
+		void update();
+
+		void setUploadBudget(std::size_t bytes) { m_settings.uploadBudgetBytes = bytes; }
+		const Stats& stats() const { return m_stats; }
+
+	private:
+		enum class State { Decoding, Uploading, Ready, Failed };
+
+		struct Job {
+			std::string path;
+			std::unique_ptr<Texture2D> texture;
+			State state = State::Decoding;
+			std::atomic<bool> cancelled{ false };
+
+			// written by the worker, read on the GL thread after the hand-off
+			DecodedImage image;
+			AssetLoadStats loadStats;
+
+			// GL thread
+			GLuint staging = 0;
+			int nextRow = 0;
+		};
+
+		void decode(const std::shared_ptr<Job>& job);
+		std::size_t uploadBands(Job& job, std::size_t budget);
+		void finish(Job& job);
+		void destroyStaging(Job& job);
+
+	private:
+		ThreadPool& m_pool;
+		Settings m_settings;
+		Stats m_stats;
+
+		std::vector<std::shared_ptr<Job>> m_jobs; // every texture handed out
+
+		// worker -> GL thread hand-off
+		mutable std::mutex m_mutex;
+		std::condition_variable m_idleCv;
+		std::deque<std::shared_ptr<Job>> m_decoded;
+		std::uint32_t m_inFlight = 0;
+
+		std::deque<std::shared_ptr<Job>> m_uploadQueue;
+		GLuint m_pbo = 0;
+		std::size_t m_pboBytes = 0;
+	};
+}
@@ -0,0 +1,144 @@
+#include "renderer/atlas_builder.h"
+#include "renderer/texture2d.h"
+#include "renderer/image_decode.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// imgui compiles its copy of stb_rect_pack as static, so this one stays private too
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "imstb_rectpack.h"
+
+namespace argon {
+
+	static int nextPow2(int v) {
+		int p = 1;
+		while (p < v) p <<= 1;
+		return p;
+	}
+
+	AtlasBuilder::AtlasBuilder() = default;
+	AtlasBuilder::AtlasBuilder(const Settings& settings) : m_settings(settings) {}
+	AtlasBuilder::~AtlasBuilder() = default;
+
+	bool AtlasBuilder::addFile(const std::string& name, const std::string& path) {
+		DecodedImage img = decodeImageFile(path);
+		if (!img.ok()) {
+			std::cerr << "[AtlasBuilder] failed to load: " << path << "\n";
+			return false;
+		}
+		addImage(name, img.width, img.height, img.pixels.get());
+		return true;
+	}
+
+	void AtlasBuilder::addImage(const std::string& name, int width, int height, const void* rgba) {
+		if (width <= 0 || height <= 0 || !rgba) return;
+		Image img;
+		img.name = name;
+		img.w = width;
+		img.h = height;
+		const std::uint8_t* src = (const std::uint8_t*)rgba;
+		img.rgba.assign(src, src + (std::size_t)width * height * 4);
+		m_images.push_back(std::move(img));
+	}
+
+	// copies the image and repeats its border m_settings.extrude texels outward
+	void AtlasBuilder::blit(std::vector<std::uint8_t>& page, int pageW, const Image& img, int x, int y) const {
+		const int e = m_settings.extrude;
+		for (int row = -e; row < img.h + e; ++row) {
+			const int srcRow = std::clamp(row, 0, img.h - 1);
+			std::uint8_t* dst = page.data() + ((std::size_t)(y + row) * pageW + x) * 4;
+			const std::uint8_t* src = img.rgba.data() + (std::size_t)srcRow * img.w * 4;
+
+			std::memcpy(dst, src, (std::size_t)img.w * 4);
+			for (int i = 1; i <= e; ++i) {
+				std::memcpy(dst - i * 4, src, 4);
+				std::memcpy(dst + (img.w - 1 + i) * 4, src + (img.w - 1) * 4, 4);
+			}
+		}
+	}
+
+	AtlasBuilder::Result AtlasBuilder::build(TextureAtlas& atlas) {
+		Result result;
+		result.ids.assign(m_images.size(), 0);
+		if (m_images.empty()) return result;
+
+		const int pageW = m_settings.pageWidth;
+		const int pageH = m_settings.pageHeight;
+		const int border = m_settings.extrude * 2 + m_settings.padding;
+
+		std::vector<stbrp_rect> pending;
+		pending.reserve(m_images.size());
+		for (std::size_t i = 0; i < m_images.size(); ++i) {
+			stbrp_rect r{};
+			r.id = (int)i;
+			r.w = m_images[i].w + border;
+			r.h = m_images[i].h + border;
+			if (r.w > pageW || r.h > pageH) {
+				std::cerr << "[AtlasBuilder] " << m_images[i].name << " (" << m_images[i].w << "x"
+						  << m_images[i].h << ") does not fit a " << pageW << "x" << pageH << " page\n";
+				continue;
+			}
+			pending.push_back(r);
+		}
+
+		// fill page after page with whatever did not fit the previous one
+		std::vector<Placement> placements(m_images.size());
+		std::vector<stbrp_node> nodes((std::size_t)pageW);
+		int pageCount = 0;
+		while (!pending.empty()) {
+			stbrp_context ctx;
+			stbrp_init_target(&ctx, pageW, pageH, nodes.data(), (int)nodes.size());
+			stbrp_pack_rects(&ctx, pending.data(), (int)pending.size());
+
+			std::vector<stbrp_rect> rest;
+			for (const stbrp_rect& r : pending) {
+				if (!r.was_packed) { rest.push_back(r); continue; }
+				Placement& p = placements[(std::size_t)r.id];
+				p.page = pageCount;
+				p.x = r.x + m_settings.extrude;
+				p.y = r.y + m_settings.extrude;
+			}
+			if (rest.size() == pending.size()) break; // cannot happen: every rect fits an empty page
+			pending.swap(rest);
+			pageCount++;
+		}
+
+		for (int page = 0; page < pageCount; ++page) {
+			int w = pageW, h = pageH;
+			if (m_settings.shrinkLastPage && page == pageCount - 1) {
+				int usedW = 0, usedH = 0;
+				for (std::size_t i = 0; i < m_images.size(); ++i) {
+					if (placements[i].page != page) continue;
+					usedW = std::max(usedW, placements[i].x + m_images[i].w + m_settings.extrude);
+					usedH = std::max(usedH, placements[i].y + m_images[i].h + m_settings.extrude);
+				}
+				w = std::min(pageW, nextPow2(usedW));
+				h = std::min(pageH, nextPow2(usedH));
+			}
+
+			std::vector<std::uint8_t> pixels((std::size_t)w * h * 4, 0);
+			for (std::size_t i = 0; i < m_images.size(); ++i) {
+				if (placements[i].page == page) blit(pixels, w, m_images[i], placements[i].x, placements[i].y);
+			}
+			const std::uint32_t pageIndex = atlas.addPage(std::make_unique<Texture2D>(w, h, pixels.data()));
+			result.pages.push_back(pageIndex);
+
+			const float invW = 1.0f / (float)w;
+			const float invH = 1.0f / (float)h;
+			for (std::size_t i = 0; i < m_images.size(); ++i) {
+				const Placement& p = placements[i];
+				if (p.page != page) continue;
+				const Image& img = m_images[i];
+
+				// exact edges: the extruded border covers bilinear taps outside the rect
+				const Vec4 uv{ p.x * invW, p.y * invH, (p.x + img.w) * invW, (p.y + img.h) * invH };
+				result.ids[i] = atlas.addSprite(img.name, uv, pageIndex);
+			}
+		}
+
+		m_images.clear();
+		return result;
+	}
+}
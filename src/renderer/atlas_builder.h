@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "renderer/texture_atlas.h"
+
+namespace argon {
+
+	// Packs loose images into one or more atlas pages at load time
+	// (stb_rect_pack skyline), uploads every page once, hands it to the
+	// TextureAtlas and registers each image as a sprite on it.
+	class AtlasBuilder {
+	public:
+		struct Settings {
+			int pageWidth = 2048;
+			int pageHeight = 2048;
+			int padding = 2;  // empty texels between neighbouring sprites
+			int extrude = 1;  // edge texels repeated outward, stops bilinear bleeding
+			bool shrinkLastPage = true; // trim the last page to a power of two that fits its content
+		};
+
+		struct Result {
+			std::vector<std::uint32_t> pages;       // atlas pages created, owned by the atlas
+			std::vector<TextureAtlas::SpriteId> ids; // per added image, in add order (0 = not packed)
+		};
+
+		AtlasBuilder();
+		explicit AtlasBuilder(const Settings& settings);
+		~AtlasBuilder();
+
+		// decodes right away; false if the file can't be read
+		bool addFile(const std::string& name, const std::string& path);
+		// copies tightly packed RGBA8 pixels, rows bottom to top (Texture2D convention)
+		void addImage(const std::string& name, int width, int height, const void* rgba);
+
+		std::size_t imageCount() const { return m_images.size(); }
+
+		// Pack everything added so far, upload the pages as new pages of atlas and
+		// register the sprites on them. Images larger than a page are reported
+		// and skipped. The builder is empty afterwards.
+		Result build(TextureAtlas& atlas);
+
+	private:
+		struct Image {
+			std::string name;
+			int w = 0, h = 0;
+			std::vector<std::uint8_t> rgba;
+		};
+
+		struct Placement {
+			int page = -1;
+			int x = 0, y = 0; // of the image itself, inside padding + extrusion
+		};
+
+		void blit(std::vector<std::uint8_t>& page, int pageW, const Image& img, int x, int y) const;
+
+	private:
+		Settings m_settings;
+		std::vector<Image> m_images;
+	};
+}
@@ -0,0 +1,65 @@
+#include "renderer/cooked_texture_file.h"
+#include <iostream>
+
+namespace argon {
+
+	static bool inRange(std::uint64_t offset, std::uint64_t size, std::uint64_t fileSize) {
+		return offset <= fileSize && size <= fileSize - offset;
+	}
+
+	bool CookedTextureFile::isCookedPath(const std::string& path) {
+		static constexpr std::string_view ext = ".atex";
+		return path.size() >= ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0;
+	}
+
+	bool CookedTextureFile::open(const std::string& path) {
+		close();
+		if (!m_file.open(path)) {
+			std::cerr << "Failed to map cooked texture: " << path << "\n";
+			return false;
+		}
+
+		const std::uint64_t size = m_file.size();
+		const std::uint8_t* base = m_file.data();
+		auto fail = [&](const char* why) {
+			std::cerr << "Invalid cooked texture " << path << ": " << why << "\n";
+			close();
+			return false;
+		};
+
+		if (size < sizeof(cooked::FileHeader)) return fail("truncated header");
+		const auto* h = (const cooked::FileHeader*)base;
+		if (h->magic != cooked::kMagic) return fail("bad magic");
+		if (h->version != cooked::kVersion) return fail("unsupported version, re-cook the asset");
+		if (h->format != (std::uint32_t)cooked::PixelFormat::RGBA8) return fail("unknown pixel format");
+		if (h->width == 0 || h->height == 0 || h->mipCount == 0) return fail("empty image");
+
+		if (h->mipTableOffset % 8 || h->rectTableOffset % 8) return fail("misaligned tables");
+		if (!inRange(h->mipTableOffset, (std::uint64_t)h->mipCount * sizeof(cooked::MipEntry), size)) return fail("mip table out of range");
+		if (!inRange(h->rectTableOffset, (std::uint64_t)h->rectCount * sizeof(cooked::RectEntry), size)) return fail("rect table out of range");
+		if (!inRange(h->nameTableOffset, h->nameTableSize, size)) return fail("name table out of range");
+
+		const auto* mips = (const cooked::MipEntry*)(base + h->mipTableOffset);
+		for (std::uint32_t i = 0; i < h->mipCount; ++i) {
+			const cooked::MipEntry& m = mips[i];
+			if (m.size != (std::uint64_t)m.width * m.height * 4) return fail("mip size mismatch");
+			if (!inRange(m.offset, m.size, size)) return fail("mip data out of range");
+		}
+
+		const auto* rects = (const cooked::RectEntry*)(base + h->rectTableOffset);
+		for (std::uint32_t i = 0; i < h->rectCount; ++i) {
+			if (!inRange(rects[i].nameOffset, rects[i].nameLength, h->nameTableSize)) return fail("rect name out of range");
+		}
+
+		m_header = h;
+		m_mips = mips;
+		m_rects = rects;
+		m_names = (const char*)(base + h->nameTableOffset);
+		return true;
+	}
+
+	std::string_view CookedTextureFile::rectName(std::uint32_t i) const {
+		const cooked::RectEntry& r = m_rects[i];
+		return { m_names + r.nameOffset, r.nameLength };
+	}
+}
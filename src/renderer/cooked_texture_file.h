@@ -0,0 +1,39 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "platform/mapped_file.h"
+#include "renderer/cooked_texture_format.h"
+
+namespace argon {
+
+	// Maps a cooked .atex file and exposes its tables in place. open() only
+	// validates offsets against the file size, nothing is copied or decoded.
+	class CookedTextureFile {
+	public:
+		bool open(const std::string& path);
+		void close() { m_file.close(); m_header = nullptr; }
+
+		bool isOpen() const { return m_header != nullptr; }
+		std::size_t fileSize() const { return m_file.size(); }
+
+		const cooked::FileHeader& header() const { return *m_header; }
+
+		std::uint32_t mipCount() const { return m_header->mipCount; }
+		const cooked::MipEntry& mip(std::uint32_t level) const { return m_mips[level]; }
+		const std::uint8_t* mipData(std::uint32_t level) const { return m_file.data() + m_mips[level].offset; }
+
+		std::uint32_t rectCount() const { return m_header->rectCount; }
+		const cooked::RectEntry& rect(std::uint32_t i) const { return m_rects[i]; }
+		std::string_view rectName(std::uint32_t i) const;
+
+		static bool isCookedPath(const std::string& path);
+
+	private:
+		MappedFile m_file;
+		const cooked::FileHeader* m_header = nullptr;
+		const cooked::MipEntry* m_mips = nullptr;
+		const cooked::RectEntry* m_rects = nullptr;
+		const char* m_names = nullptr;
+	};
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+
+// On-disk layout of cooked textures (.atex), shared by the argon_cook tool and
+// the runtime loader. Everything is little endian and GPU ready: pixel data is
+// uploaded straight from the file mapping, the rect table is read in place.
+//
+//   FileHeader
+//   MipEntry  [mipCount]    at mipTableOffset
+//   RectEntry [rectCount]   at rectTableOffset
+//   name bytes              at nameTableOffset (not null terminated)
+//   mip pixels              at MipEntry::offset, 16-byte aligned
+//
+// Rows are stored bottom to top, the same convention Texture2D uploads with.
+
+namespace argon {
+	namespace cooked {
+
+		static constexpr std::uint32_t kMagic = 0x58455441u; // "ATEX"
+		static constexpr std::uint32_t kVersion = 1;
+		static constexpr std::uint32_t kDataAlignment = 16;
+
+		enum class PixelFormat : std::uint32_t {
+			RGBA8 = 1,
+		};
+
+		struct FileHeader {
+			std::uint32_t magic = kMagic;
+			std::uint32_t version = kVersion;
+			std::uint32_t format = (std::uint32_t)PixelFormat::RGBA8;
+			std::uint32_t width = 0;
+			std::uint32_t height = 0;
+			std::uint32_t mipCount = 0;
+			std::uint32_t rectCount = 0;
+			std::uint32_t flags = 0;
+			std::uint64_t mipTableOffset = 0;
+			std::uint64_t rectTableOffset = 0;
+			std::uint64_t nameTableOffset = 0;
+			std::uint64_t nameTableSize = 0;
+		};
+
+		struct MipEntry {
+			std::uint64_t offset = 0;
+			std::uint64_t size = 0;
+			std::uint32_t width = 0;
+			std::uint32_t height = 0;
+		};
+
+		// pixel rect of an atlas sprite on mip 0, same meaning as a .atlas line
+		struct RectEntry {
+			std::uint32_t nameOffset = 0; // into the name table
+			std::uint32_t nameLength = 0;
+			std::int32_t x = 0, y = 0, w = 0, h = 0;
+		};
+
+		static_assert(sizeof(FileHeader) == 64, "cooked FileHeader layout changed, bump kVersion");
+		static_assert(sizeof(MipEntry) == 24, "cooked MipEntry layout changed, bump kVersion");
+		static_assert(sizeof(RectEntry) == 24, "cooked RectEntry layout changed, bump kVersion");
+	}
+}
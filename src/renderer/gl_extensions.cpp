@@ -0,0 +1,56 @@
+#include "renderer/gl_extensions.h"
+#include <cstring>
+
+namespace argon {
+
+	static GLExtensions s_ext;
+
+	static bool hasExtension(const char* name) {
+		GLint count = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+		for (GLint i = 0; i < count; ++i) {
+			const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, (GLuint)i);
+			if (ext && std::strcmp(ext, name) == 0) return true;
+		}
+		return false;
+	}
+
+	static bool atLeast(int major, int minor) {
+		return s_ext.major > major || (s_ext.major == major && s_ext.minor >= minor);
+	}
+
+	bool loadGLExtensions(GLADloadproc load) {
+		s_ext = GLExtensions{};
+		if (!load) return false;
+
+		glGetIntegerv(GL_MAJOR_VERSION, &s_ext.major);
+		glGetIntegerv(GL_MINOR_VERSION, &s_ext.minor);
+
+		if (atLeast(4, 4) || hasExtension("GL_ARB_buffer_storage")) {
+			s_ext.BufferStorage = (PFNARGONBUFFERSTORAGEPROC)load("glBufferStorage");
+			s_ext.bufferStorage = s_ext.BufferStorage != nullptr;
+		}
+
+		if (atLeast(4, 2) || hasExtension("GL_ARB_base_instance")) {
+			s_ext.DrawArraysInstancedBaseInstance =
+				(PFNARGONDRAWARRAYSINSTANCEDBASEINSTANCEPROC)load("glDrawArraysInstancedBaseInstance");
+			s_ext.baseInstance = s_ext.DrawArraysInstancedBaseInstance != nullptr;
+		}
+
+		if (atLeast(4, 1) || hasExtension("GL_ARB_get_program_binary")) {
+			GLint formats = 0;
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+			s_ext.GetProgramBinary = (PFNARGONGETPROGRAMBINARYPROC)load("glGetProgramBinary");
+			s_ext.ProgramBinary = (PFNARGONPROGRAMBINARYPROC)load("glProgramBinary");
+			s_ext.ProgramParameteri = (PFNARGONPROGRAMPARAMETERIPROC)load("glProgramParameteri");
+			s_ext.programBinary = formats > 0 && s_ext.GetProgramBinary && s_ext.ProgramBinary && s_ext.ProgramParameteri;
+		}
+
+		s_ext.loaded = true;
+		return true;
+	}
+
+	const GLExtensions& glExt() {
+		return s_ext;
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <glad/glad.h>
+
+// Optional entry points beyond the GL 3.3 core profile the vendored glad loader
+// was generated for. Everything here is probed at runtime; callers must check
+// the bool before using a function pointer.
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+namespace argon {
+
+	typedef void (APIENTRYP PFNARGONBUFFERSTORAGEPROC)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+	typedef void (APIENTRYP PFNARGONDRAWARRAYSINSTANCEDBASEINSTANCEPROC)(GLenum mode, GLint first, GLsizei count,
+																		 GLsizei instancecount, GLuint baseinstance);
+	typedef void (APIENTRYP PFNARGONGETPROGRAMBINARYPROC)(GLuint program, GLsizei bufSize, GLsizei* length,
+														  GLenum* binaryFormat, void* binary);
+	typedef void (APIENTRYP PFNARGONPROGRAMBINARYPROC)(GLuint program, GLenum binaryFormat, const void* binary,
+													   GLsizei length);
+	typedef void (APIENTRYP PFNARGONPROGRAMPARAMETERIPROC)(GLuint program, GLenum pname, GLint value);
+
+	struct GLExtensions {
+		bool loaded = false;
+		int major = 3;
+		int minor = 3;
+
+		// GL 4.4 / ARB_buffer_storage
+		bool bufferStorage = false;
+		PFNARGONBUFFERSTORAGEPROC BufferStorage = nullptr;
+
+		// GL 4.2 / ARB_base_instance
+		bool baseInstance = false;
+		PFNARGONDRAWARRAYSINSTANCEDBASEINSTANCEPROC DrawArraysInstancedBaseInstance = nullptr;
+
+		// GL 4.1 / ARB_get_program_binary, with at least one binary format
+		bool programBinary = false;
+		PFNARGONGETPROGRAMBINARYPROC GetProgramBinary = nullptr;
+		PFNARGONPROGRAMBINARYPROC ProgramBinary = nullptr;
+		PFNARGONPROGRAMPARAMETERIPROC ProgramParameteri = nullptr;
+	};
+
+	// call once after gladLoadGLLoader, with the same loader, on the GL thread
+	bool loadGLExtensions(GLADloadproc load);
+	const GLExtensions& glExt();
+}
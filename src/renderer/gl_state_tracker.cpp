@@ -0,0 +1,189 @@
+#include "renderer/gl_state_tracker.h"
+
+namespace argon {
+
+	static int targetIndex(GLenum target) {
+		switch (target) {
+		case GL_TEXTURE_2D: return 0;
+		case GL_TEXTURE_BUFFER: return 1;
+		default: return -1;
+		}
+	}
+
+	static GLenum targetEnum(int index) {
+		return index == 0 ? GL_TEXTURE_2D : GL_TEXTURE_BUFFER;
+	}
+
+	static const GLenum kBufferTargets[] = { GL_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_TEXTURE_BUFFER, GL_PIXEL_UNPACK_BUFFER };
+
+	static int bufferTargetIndex(GLenum target) {
+		for (int i = 0; i < (int)(sizeof(kBufferTargets) / sizeof(kBufferTargets[0])); ++i) {
+			if (kBufferTargets[i] == target) return i;
+		}
+		return -1;
+	}
+
+	GLStateTracker::GLStateTracker() {
+		invalidate();
+		m_stats.invalidations = 0;
+	}
+
+	bool GLStateTracker::useProgram(GLuint program) {
+		if (m_program == program) return skip();
+		glUseProgram(program);
+		m_program = program;
+		issue();
+		return true;
+	}
+
+	bool GLStateTracker::bindVertexArray(GLuint vao) {
+		if (m_vao == vao) return skip();
+		glBindVertexArray(vao);
+		m_vao = vao;
+		issue();
+		return true;
+	}
+
+	bool GLStateTracker::bindBuffer(GLenum target, GLuint buffer) {
+		const int t = bufferTargetIndex(target);
+		if (t >= 0 && m_buffers[t] == buffer) return skip();
+		glBindBuffer(target, buffer);
+		if (t >= 0) m_buffers[t] = buffer;
+		issue();
+		return true;
+	}
+
+	bool GLStateTracker::bindUniformBufferBase(GLuint index, GLuint buffer) {
+		const bool tracked = index < (GLuint)kTrackedUniformBindings;
+		if (tracked && m_uniformBindings[index] == buffer && m_buffers[kBufferUniform] == buffer) return skip();
+		glBindBufferBase(GL_UNIFORM_BUFFER, index, buffer);
+		if (tracked) m_uniformBindings[index] = buffer;
+		m_buffers[kBufferUniform] = buffer;
+		issue();
+		return true;
+	}
+
+	bool GLStateTracker::activeTexture(int unit) {
+		if (m_activeUnit == (std::uint32_t)unit) return skip();
+		glActiveTexture(GL_TEXTURE0 + unit);
+		m_activeUnit = (std::uint32_t)unit;
+		issue();
+		return true;
+	}
+
+	bool GLStateTracker::bindTexture(int unit, GLenum target, GLuint texture) {
+		const int t = targetIndex(target);
+		const bool tracked = t >= 0 && unit >= 0 && unit < kTrackedUnits;
+		if (tracked && m_textures[unit][t] == texture) return skip();
+
+		activeTexture(unit);
+		glBindTexture(target, texture);
+		if (tracked) m_textures[unit][t] = texture;
+		issue();
+		return true;
+	}
+
+	bool GLStateTracker::setBlend(bool enabled) {
+		const std::uint32_t v = enabled ? 1u : 0u;
+		if (m_blend == v) return skip();
+		if (enabled) glEnable(GL_BLEND);
+		else glDisable(GL_BLEND);
+		m_blend = v;
+		issue();
+		return true;
+	}
+
+	bool GLStateTracker::setBlendFunc(GLenum src, GLenum dst) {
+		if (m_blendSrc == src && m_blendDst == dst) return skip();
+		glBlendFunc(src, dst);
+		m_blendSrc = src;
+		m_blendDst = dst;
+		issue();
+		return true;
+	}
+
+	bool GLStateTracker::setViewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+		if (m_viewportKnown && m_viewport[0] == x && m_viewport[1] == y &&
+			m_viewport[2] == width && m_viewport[3] == height) return skip();
+		glViewport(x, y, width, height);
+		m_viewport[0] = x;
+		m_viewport[1] = y;
+		m_viewport[2] = width;
+		m_viewport[3] = height;
+		m_viewportKnown = true;
+		issue();
+		return true;
+	}
+
+	void GLStateTracker::forgetProgram(GLuint program) {
+		if (m_program == program) m_program = kUnknown;
+	}
+
+	void GLStateTracker::forgetVertexArray(GLuint vao) {
+		if (m_vao == vao) m_vao = kUnknown;
+	}
+
+	void GLStateTracker::forgetBuffer(GLuint buffer) {
+		for (std::uint32_t& bound : m_buffers) {
+			if (bound == buffer) bound = kUnknown;
+		}
+		for (std::uint32_t& bound : m_uniformBindings) {
+			if (bound == buffer) bound = kUnknown;
+		}
+	}
+
+	void GLStateTracker::forgetTexture(GLuint texture) {
+		for (auto& unit : m_textures) {
+			for (std::uint32_t& bound : unit) {
+				if (bound == texture) bound = kUnknown;
+			}
+		}
+	}
+
+	void GLStateTracker::invalidate() {
+		m_program = kUnknown;
+		m_vao = kUnknown;
+		for (std::uint32_t& bound : m_buffers) bound = kUnknown;
+		for (std::uint32_t& bound : m_uniformBindings) bound = kUnknown;
+		m_activeUnit = kUnknown;
+		for (auto& unit : m_textures) {
+			for (std::uint32_t& bound : unit) bound = kUnknown;
+		}
+		m_blend = kUnknown;
+		m_blendSrc = kUnknown;
+		m_blendDst = kUnknown;
+		m_viewportKnown = false;
+		m_stats.invalidations++;
+	}
+
+	void GLStateTracker::restore() {
+		if (m_program != kUnknown) glUseProgram(m_program);
+		if (m_vao != kUnknown) glBindVertexArray(m_vao);
+		for (GLuint index = 0; index < (GLuint)kTrackedUniformBindings; ++index) {
+			if (m_uniformBindings[index] != kUnknown) glBindBufferBase(GL_UNIFORM_BUFFER, index, m_uniformBindings[index]);
+		}
+		// after the indexed binds, which move the generic uniform target
+		for (int t = 0; t < kBufferTargetCount; ++t) {
+			if (m_buffers[t] != kUnknown) glBindBuffer(kBufferTargets[t], m_buffers[t]);
+		}
+		for (int unit = 0; unit < kTrackedUnits; ++unit) {
+			for (int t = 0; t < kTargetCount; ++t) {
+				if (m_textures[unit][t] == kUnknown) continue;
+				glActiveTexture(GL_TEXTURE0 + unit);
+				glBindTexture(targetEnum(t), m_textures[unit][t]);
+			}
+		}
+		// the loop above moved the active unit; leave it where the tracker says
+		if (m_activeUnit != kUnknown) glActiveTexture(GL_TEXTURE0 + m_activeUnit);
+		if (m_blend == 1) glEnable(GL_BLEND);
+		else if (m_blend == 0) glDisable(GL_BLEND);
+		if (m_blendSrc != kUnknown) glBlendFunc(m_blendSrc, m_blendDst);
+		if (m_viewportKnown) glViewport(m_viewport[0], m_viewport[1], m_viewport[2], m_viewport[3]);
+		m_stats.restores++;
+	}
+
+	GLStateTracker& glState() {
+		static GLStateTracker s_state;
+		return s_state;
+	}
+}
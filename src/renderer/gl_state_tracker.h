@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <glad/glad.h>
+
+namespace argon {
+
+	// Engine-wide shadow of the GL state the engine touches: program, vertex
+	// array, the array/uniform/texture/pixel unpack buffer targets, the indexed
+	// uniform buffer bindings, active texture unit, 2D and buffer texture
+	// bindings per unit, blending and viewport. Engine code binds through it, so a bind
+	// that matches what is already current never reaches GL, across flushes,
+	// passes and frames.
+	//
+	// It assumes nothing else changes that state. Code that does (ImGui's
+	// backend, third-party renderers) is bracketed with either invalidate(),
+	// which forgets everything so the next engine bind of each kind is issued,
+	// or restore(), which pushes the tracked state back to GL.
+	//
+	// GL thread only. Resource destructors call forget*() because deleting a
+	// bound object resets the binding to 0 and its name may be reused.
+	class GLStateTracker {
+	public:
+		// texture units the sprite batcher spreads one batch over
+		static constexpr int kTextureUnits = 8;
+		// units whose bindings are tracked; binds above fall through to GL
+		static constexpr int kTrackedUnits = 16;
+		// indexed uniform buffer binding points tracked, the same way
+		static constexpr int kTrackedUniformBindings = 4;
+
+		struct Stats {
+			std::uint64_t issued = 0;    // calls forwarded to GL
+			std::uint64_t skipped = 0;   // calls dropped, the state was already current
+			std::uint64_t invalidations = 0;
+			std::uint64_t restores = 0;
+		};
+
+		// starts with every state unknown
+		GLStateTracker();
+
+		// each returns true when it issued a GL call
+		bool useProgram(GLuint program);
+		bool bindVertexArray(GLuint vao);
+		bool bindArrayBuffer(GLuint buffer) { return bindBuffer(GL_ARRAY_BUFFER, buffer); }
+		// GL_ARRAY_BUFFER, GL_UNIFORM_BUFFER, GL_TEXTURE_BUFFER and
+		// GL_PIXEL_UNPACK_BUFFER are tracked; other targets fall through to GL
+		bool bindBuffer(GLenum target, GLuint buffer);
+		// glBindBufferBase on GL_UNIFORM_BUFFER; also binds the generic target, as GL does
+		bool bindUniformBufferBase(GLuint index, GLuint buffer);
+		bool activeTexture(int unit);
+		// GL_TEXTURE_2D and GL_TEXTURE_BUFFER are tracked; switches the active unit
+		bool bindTexture(int unit, GLenum target, GLuint texture);
+		// on whatever unit is active, for uploads
+		bool bindTexture(GLenum target, GLuint texture) { return bindTexture(activeUnit(), target, texture); }
+		bool setBlend(bool enabled);
+		bool setBlendFunc(GLenum src, GLenum dst);
+		bool setViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+		int activeUnit() const { return m_activeUnit == kUnknown ? 0 : (int)m_activeUnit; }
+
+		// the object was deleted: GL unbound it wherever it was bound
+		void forgetProgram(GLuint program);
+		void forgetVertexArray(GLuint vao);
+		void forgetBuffer(GLuint buffer);
+		void forgetTexture(GLuint texture);
+
+		// foreign code changed GL state: re-issue every kind on next use
+		void invalidate();
+		// foreign code changed GL state: put back everything still tracked
+		void restore();
+
+		const Stats& stats() const { return m_stats; }
+
+	private:
+		static constexpr std::uint32_t kUnknown = 0xFFFFFFFFu;
+		enum TextureTarget { kTarget2D = 0, kTargetBuffer, kTargetCount };
+		enum BufferTarget { kBufferArray = 0, kBufferUniform, kBufferTexture, kBufferPixelUnpack, kBufferTargetCount };
+
+		bool skip() { m_stats.skipped++; return false; }
+		void issue() { m_stats.issued++; }
+
+		std::uint32_t m_program = kUnknown;
+		std::uint32_t m_vao = kUnknown;
+		std::uint32_t m_buffers[kBufferTargetCount];
+		std::uint32_t m_uniformBindings[kTrackedUniformBindings];
+		std::uint32_t m_activeUnit = kUnknown;
+		std::uint32_t m_textures[kTrackedUnits][kTargetCount];
+		std::uint32_t m_blend = kUnknown; // 0 / 1
+		std::uint32_t m_blendSrc = kUnknown;
+		std::uint32_t m_blendDst = kUnknown;
+		GLint m_viewport[4] = {};
+		bool m_viewportKnown = false;
+
+		Stats m_stats;
+	};
+
+	GLStateTracker& glState();
+}
@@ -0,0 +1,41 @@
+#include "renderer/image_decode.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+namespace argon {
+
+	void DecodedPixelsDeleter::operator()(std::uint8_t* p) const {
+		stbi_image_free(p);
+	}
+
+	void flipRowsInPlace(std::uint8_t* rgba, int width, int height) {
+		const std::size_t rowBytes = (std::size_t)width * 4;
+		for (int top = 0, bottom = height - 1; top < bottom; ++top, --bottom) {
+			std::swap_ranges(rgba + top * rowBytes, rgba + (top + 1) * rowBytes, rgba + bottom * rowBytes);
+		}
+	}
+
+	DecodedImage decodeImageRGBA(const void* bytes, std::size_t size, bool flipRows) {
+		DecodedImage img;
+		if (!bytes || size == 0) return img;
+
+		int channels = 0;
+		img.pixels.reset(stbi_load_from_memory((const stbi_uc*)bytes, (int)size, &img.width, &img.height, &channels, 4));
+		if (!img.ok()) return img;
+
+		if (flipRows) flipRowsInPlace(img.pixels.get(), img.width, img.height);
+		return img;
+	}
+
+	DecodedImage decodeImageFile(const std::string& path, bool flipRows) {
+		std::ifstream in(path, std::ios::binary);
+		if (!in.is_open()) return {};
+		std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		return decodeImageRGBA(bytes.data(), bytes.size(), flipRows);
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace argon {
+
+	struct DecodedPixelsDeleter {
+		void operator()(std::uint8_t* p) const;
+	};
+
+	// RGBA8 pixels owned by stb_image
+	struct DecodedImage {
+		int width = 0;
+		int height = 0;
+		std::unique_ptr<std::uint8_t, DecodedPixelsDeleter> pixels;
+
+		bool ok() const { return pixels != nullptr; }
+		std::size_t byteSize() const { return (std::size_t)width * height * 4; }
+		std::size_t rowBytes() const { return (std::size_t)width * 4; }
+	};
+
+	// Safe to call from any thread: stb_image's process-wide flip flag is never
+	// touched, flipRows swaps the rows here so they end up bottom to top like
+	// Texture2D expects.
+	DecodedImage decodeImageRGBA(const void* bytes, std::size_t size, bool flipRows = true);
+	DecodedImage decodeImageFile(const std::string& path, bool flipRows = true);
+
+	void flipRowsInPlace(std::uint8_t* rgba, int width, int height);
+}
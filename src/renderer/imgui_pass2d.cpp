@@ -2,6 +2,7 @@
 #include "imgui.h"
 #include "backends/imgui_impl_glfw.h"
 #include "backends/imgui_impl_opengl3.h"
+#include "renderer/gl_state_tracker.h"
 
 namespace argon {
 	void ImGuiPass2D::execute(const RenderFrame2D& frame, Renderer& renderer) {
@@ -14,10 +15,26 @@ namespace argon {
 		const auto& s = renderer.stats();
 		ImGui::Text("drawCalls: %u", s.drawCalls);
 		ImGui::Text("batchFlushes: %u", s.batchFlushes);
+		ImGui::Text("sort: %.3f ms%s", s.sortMs, s.sortParallel ? " (parallel)" : "");
+		ImGui::Text("instance upload: %u KB, fence waits: %u", s.instanceBytes / 1024, s.ringFenceWaits);
+		ImGui::Text("gl state: %u issued, %u skipped", s.stateCalls, s.stateSkips);
+
+		int layout = (int)renderer.spriteInstanceLayout();
+		ImGui::Text("sprite instances:");
+		bool changed = ImGui::RadioButton("full", &layout, (int)SpriteInstanceLayout::Full);
+		ImGui::SameLine();
+		changed |= ImGui::RadioButton("compact", &layout, (int)SpriteInstanceLayout::Compact);
+		ImGui::SameLine();
+		changed |= ImGui::RadioButton("trs (gpu transform)", &layout, (int)SpriteInstanceLayout::Trs);
+		if (changed) {
+			renderer.setSpriteInstanceLayout((SpriteInstanceLayout)layout);
+		}
 		ImGui::End();
 
 		ImGui::Render();
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+		// the backend binds behind the engine's tracker
+		glState().invalidate();
 	}
 
 
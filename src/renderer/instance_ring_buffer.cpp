@@ -0,0 +1,144 @@
+#include "renderer/instance_ring_buffer.h"
+#include "renderer/gl_extensions.h"
+#include "renderer/gl_state_tracker.h"
+#include <cassert>
+
+namespace argon {
+
+	InstanceRingBuffer::~InstanceRingBuffer() {
+		release();
+	}
+
+	static inline std::size_t alignUp(std::size_t v, std::size_t a) {
+		return a > 1 ? (v + a - 1) / a * a : v;
+	}
+
+	void InstanceRingBuffer::init(std::size_t segmentBytes) {
+		if (m_buffer) return;
+		allocate(segmentBytes);
+	}
+
+	void InstanceRingBuffer::allocate(std::size_t segmentBytes) {
+		const std::size_t total = segmentBytes * kFramesInFlight;
+
+		glGenBuffers(1, &m_buffer);
+		glState().bindArrayBuffer(m_buffer);
+
+		const GLExtensions& ext = glExt();
+		if (ext.bufferStorage) {
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			ext.BufferStorage(GL_ARRAY_BUFFER, (GLsizeiptr)total, nullptr, flags);
+			m_persistentPtr = (std::uint8_t*)glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)total, flags);
+		}
+		if (!m_persistentPtr) {
+			glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)total, nullptr, GL_STREAM_DRAW);
+		}
+		glState().bindArrayBuffer(0);
+
+		m_segmentBytes = segmentBytes;
+		m_segment = 0;
+		m_cursor = 0;
+		m_segmentEnd = segmentBytes;
+	}
+
+	void InstanceRingBuffer::release() {
+		for (GLsync& f : m_fences) {
+			if (f) glDeleteSync(f);
+			f = nullptr;
+		}
+		if (m_buffer) {
+			if (m_persistentPtr) {
+				glState().bindArrayBuffer(m_buffer);
+				glUnmapBuffer(GL_ARRAY_BUFFER);
+				glState().bindArrayBuffer(0);
+			}
+			glState().forgetBuffer(m_buffer);
+			glDeleteBuffers(1, &m_buffer);
+		}
+		m_buffer = 0;
+		m_persistentPtr = nullptr;
+		m_writeOpen = false;
+	}
+
+	void InstanceRingBuffer::waitFence(int segment) {
+		GLsync& f = m_fences[segment];
+		if (!f) return;
+
+		GLenum r = glClientWaitSync(f, 0, 0);
+		if (r == GL_TIMEOUT_EXPIRED) {
+			m_fenceWaits++;
+			do {
+				r = glClientWaitSync(f, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+			} while (r == GL_TIMEOUT_EXPIRED);
+		}
+		glDeleteSync(f);
+		f = nullptr;
+	}
+
+	void InstanceRingBuffer::beginFrame() {
+		if (!m_buffer) return;
+		assert(!m_writeOpen && "InstanceRingBuffer: write still open at frame start");
+		m_segment = (m_segment + 1) % kFramesInFlight;
+		waitFence(m_segment);
+		m_cursor = (std::size_t)m_segment * m_segmentBytes;
+		m_segmentEnd = m_cursor + m_segmentBytes;
+	}
+
+	void InstanceRingBuffer::endFrame() {
+		if (!m_buffer) return;
+		GLsync& f = m_fences[m_segment];
+		if (f) glDeleteSync(f);
+		f = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	std::size_t InstanceRingBuffer::remaining(std::size_t alignment) const {
+		const std::size_t start = alignUp(m_cursor, alignment);
+		return start < m_segmentEnd ? m_segmentEnd - start : 0;
+	}
+
+	std::uint8_t* InstanceRingBuffer::beginWrite(std::size_t maxBytes, std::size_t alignment) {
+		assert(!m_writeOpen && "InstanceRingBuffer: nested write");
+		if (!m_buffer) return nullptr;
+		const std::size_t avail = remaining(alignment);
+		if (maxBytes > avail) maxBytes = avail;
+		if (maxBytes == 0) return nullptr;
+		m_cursor = alignUp(m_cursor, alignment);
+
+		m_writeOffset = m_cursor;
+		m_writeOpen = true;
+		if (m_persistentPtr) return m_persistentPtr + m_cursor;
+
+		glState().bindArrayBuffer(m_buffer);
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+								 GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_FLUSH_EXPLICIT_BIT;
+		void* p = glMapBufferRange(GL_ARRAY_BUFFER, (GLintptr)m_cursor, (GLsizeiptr)maxBytes, flags);
+		if (!p) m_writeOpen = false;
+		return (std::uint8_t*)p;
+	}
+
+	std::size_t InstanceRingBuffer::endWrite(std::size_t usedBytes) {
+		assert(m_writeOpen && "InstanceRingBuffer: endWrite without beginWrite");
+		m_writeOpen = false;
+
+		if (!m_persistentPtr) {
+			glState().bindArrayBuffer(m_buffer);
+			if (usedBytes) glFlushMappedBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)usedBytes);
+			glUnmapBuffer(GL_ARRAY_BUFFER);
+		}
+
+		const std::size_t offset = m_writeOffset;
+		m_cursor += usedBytes;
+		if (m_cursor > m_segmentEnd) m_cursor = m_segmentEnd;
+		return offset;
+	}
+
+	void InstanceRingBuffer::grow(std::size_t minSegmentBytes) {
+		assert(!m_writeOpen && "InstanceRingBuffer: grow while a write is open");
+		std::size_t bytes = m_segmentBytes ? m_segmentBytes : 1;
+		while (bytes < minSegmentBytes) bytes *= 2;
+
+		// the old buffer is orphaned to the driver, its pending draws stay valid
+		release();
+		allocate(bytes);
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace argon {
+
+	// Streaming vertex buffer split into one segment per frame in flight.
+	// Writes go straight into mapped memory: a persistent coherent mapping when
+	// ARB_buffer_storage is available, otherwise an unsynchronized
+	// glMapBufferRange per write. A fence per segment guards reuse, so the
+	// driver never copies or reallocates on the hot path.
+	class InstanceRingBuffer {
+	public:
+		static constexpr int kFramesInFlight = 3;
+
+		InstanceRingBuffer() = default;
+		~InstanceRingBuffer();
+
+		InstanceRingBuffer(const InstanceRingBuffer&) = delete;
+		InstanceRingBuffer& operator=(const InstanceRingBuffer&) = delete;
+
+		void init(std::size_t segmentBytes);
+		bool valid() const { return m_buffer != 0; }
+
+		// advance to the next segment, waiting for the GPU if it still reads it
+		void beginFrame();
+		// fence everything written into the current segment
+		void endFrame();
+
+		// Map up to maxBytes at the write cursor rounded up to a multiple of
+		// alignment (the element stride, so offset / stride is a base instance);
+		// nullptr if the segment is full.
+		// The buffer must not be drawn from between beginWrite and endWrite.
+		std::uint8_t* beginWrite(std::size_t maxBytes, std::size_t alignment);
+		// Commit the first usedBytes of the open write, returns its byte offset in buffer().
+		std::size_t endWrite(std::size_t usedBytes);
+
+		std::size_t remaining() const { return m_segmentEnd - m_cursor; }
+		// bytes available to a write with this alignment
+		std::size_t remaining(std::size_t alignment) const;
+		std::size_t segmentBytes() const { return m_segmentBytes; }
+
+		// Reallocate with larger segments. Draws already issued keep the old
+		// storage alive in the driver; the write cursor restarts in the new buffer.
+		void grow(std::size_t minSegmentBytes);
+
+		GLuint buffer() const { return m_buffer; }
+		bool persistent() const { return m_persistentPtr != nullptr; }
+
+		// frames whose beginFrame had to block on a fence since the last call
+		std::uint32_t takeFenceWaits() { std::uint32_t n = m_fenceWaits; m_fenceWaits = 0; return n; }
+
+	private:
+		void allocate(std::size_t segmentBytes);
+		void release();
+		void waitFence(int segment);
+
+	private:
+		GLuint m_buffer = 0;
+		std::uint8_t* m_persistentPtr = nullptr;
+		GLsync m_fences[kFramesInFlight] = {};
+
+		std::size_t m_segmentBytes = 0;
+		int m_segment = 0;
+		std::size_t m_cursor = 0;
+		std::size_t m_segmentEnd = 0;
+
+		bool m_writeOpen = false;
+		std::size_t m_writeOffset = 0;
+
+		std::uint32_t m_fenceWaits = 0;
+	};
+}
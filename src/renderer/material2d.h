@@ -1,5 +1,7 @@
 #pragma once
+#include <cstdint>
 #include "renderer/shader.h"
+#include "renderer/shader_permutations.h"
 #include "renderer/texture2d.h"
 
 namespace argon {
@@ -9,8 +11,17 @@ namespace argon {
 
 	struct Material2D {
 		const Shader* shader = nullptr;
+		// when set, MaterialLibrary resolves shader to the variant for features
+		ShaderPermutations* permutations = nullptr;
+		// ShaderFeature bits. color and the Renderable2D tint reach the shader as one
+		// product, so a mask without kShaderTinted drops the entity tint too.
+		std::uint32_t features = kShaderTinted;
 		const Texture2D* texture = nullptr;
 		Vec4 color{ 1.0f, 1.0f, 1.0f, 1.0f };
-		bool useTexture = false;
+		bool translucent = false; // alpha blended: sorted after the opaque draws of its layer
+
+		bool textured() const { return (features & kShaderTextured) && texture; }
+		// feature bits the shader variant is picked by; agrees with textured()
+		std::uint32_t shaderFeatures() const { return texture ? features : (features & ~(std::uint32_t)kShaderTextured); }
 	};
-}
\ No newline at end of file
+}
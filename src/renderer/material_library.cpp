@@ -5,6 +5,7 @@ namespace argon {
 
 	MaterialHandle argon::MaterialLibrary::add(const Material2D& m) {
 		m_materials.push_back(m);
+		resolveShader(m_materials.back());
 		return (MaterialHandle)m_materials.size(); // 1-based, 0 = invalid
 	}
 
@@ -22,4 +23,16 @@ namespace argon {
 		return &m_materials[idx];
 	}
 
+	bool MaterialLibrary::setFeatures(MaterialHandle h, std::uint32_t features) {
+		Material2D* m = get(h);
+		if (!m) return false;
+		m->features = features;
+		resolveShader(*m);
+		return m->shader != nullptr;
+	}
+
+	void MaterialLibrary::resolveShader(Material2D& m) {
+		if (m.permutations) m.shader = m.permutations->variant(m.shaderFeatures());
+	}
+
 }
\ No newline at end of file
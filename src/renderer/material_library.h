@@ -7,11 +7,17 @@ namespace argon {
 
 	class MaterialLibrary {
 	public:
+		// resolves the shader variant of materials with permutations
 		MaterialHandle add(const Material2D& m);
 		const Material2D* get(MaterialHandle h) const;
 		Material2D* get(MaterialHandle h);
 
+		// changes the feature mask and re-resolves the variant; false if it failed to build
+		bool setFeatures(MaterialHandle h, std::uint32_t features);
+
 	private:
+		static void resolveShader(Material2D& m);
+
 		std::vector<Material2D> m_materials;
 	};
-}
\ No newline at end of file
+}
@@ -1,14 +1,30 @@
 #include "mesh.h"
+#include "renderer/gl_state_tracker.h"
+#include <algorithm>
+#include <atomic>
 
 namespace argon {
-	Mesh::Mesh(const std::vector<float>& vertices){
+	static std::atomic<std::uint64_t> s_nextMeshUid{ 1 };
+
+	Mesh::Mesh(const std::vector<float>& vertices)
+		: m_vertices(vertices), m_uid(s_nextMeshUid.fetch_add(1, std::memory_order_relaxed)) {
 		m_vertexCount = static_cast<int>(vertices.size() /4);
 
+		if (m_vertexCount > 0) {
+			m_localBounds = { vertices[0], vertices[1], vertices[0], vertices[1] };
+			for (std::size_t i = 4; i + 1 < vertices.size(); i += 4) {
+				m_localBounds.minX = std::min(m_localBounds.minX, vertices[i]);
+				m_localBounds.maxX = std::max(m_localBounds.maxX, vertices[i]);
+				m_localBounds.minY = std::min(m_localBounds.minY, vertices[i + 1]);
+				m_localBounds.maxY = std::max(m_localBounds.maxY, vertices[i + 1]);
+			}
+		}
+
 		glGenVertexArrays(1, &m_vao);
 		glGenBuffers(1, &m_vbo);
 
-		glBindVertexArray(m_vao);
-		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+		glState().bindVertexArray(m_vao);
+		glState().bindArrayBuffer(m_vbo);
 
 		glBufferData(GL_ARRAY_BUFFER,
 			static_cast<GLsizeiptr>(vertices.size() * sizeof(float)),
@@ -22,17 +38,20 @@ namespace argon {
 		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
 		glEnableVertexAttribArray(1);
 
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindVertexArray(0);
+		glState().bindArrayBuffer(0);
+		glState().bindVertexArray(0);
 	}
 
 	Mesh::~Mesh() {
+		glState().forgetBuffer(m_vbo);
+		glState().forgetVertexArray(m_vao);
 		if (m_vbo) glDeleteBuffers(1, &m_vbo);
 		if (m_vao) glDeleteVertexArrays(1, &m_vao);
+		RenderIds::release(RenderIdKind::Mesh, m_sortId);
 	}
 
 	void Mesh::bind() const {
-		glBindVertexArray(m_vao);
+		glState().bindVertexArray(m_vao);
 	}
 
 }
\ No newline at end of file
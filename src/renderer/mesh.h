@@ -1,6 +1,9 @@
 #pragma once
 #include <glad/glad.h>
 #include <vector>
+#include <cstdint>
+#include "renderer/render_ids.h"
+#include "math/aabb_cull.h"
 
 namespace argon {
 	class Mesh {
@@ -17,11 +20,22 @@ namespace argon {
 
 		void bind() const;
 		unsigned int vao() const { return m_vao; }
+		std::uint32_t sortId() const { return m_sortId; }
 		int vertexCount() const { return m_vertexCount; }
+		// model space bounds of the vertex positions, computed once at construction
+		const CullRect& localBounds() const { return m_localBounds; }
+		// CPU copy of the vertex data, for batchers that pack meshes into shared buffers
+		const std::vector<float>& vertices() const { return m_vertices; }
+		// never reused (unlike sortId), safe as a cache key past the mesh's lifetime
+		std::uint64_t uid() const { return m_uid; }
 
 	private:
 		GLuint m_vao = 0;
 		GLuint m_vbo = 0;
 		int m_vertexCount = 0;
+		CullRect m_localBounds;
+		std::vector<float> m_vertices;
+		std::uint64_t m_uid = 0;
+		std::uint32_t m_sortId = RenderIds::acquire(RenderIdKind::Mesh);
 	};
 }
\ No newline at end of file
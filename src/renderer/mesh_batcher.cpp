@@ -0,0 +1,271 @@
+#include "renderer/mesh_batcher.h"
+#include <glad/glad.h>
+#include <algorithm>
+
+#include "renderer/shader.h"
+#include "renderer/shader_permutations.h"
+#include "renderer/mesh.h"
+#include "renderer/texture2d.h"
+#include "renderer/gl_state_tracker.h"
+
+namespace argon {
+
+	// draw ids are k << shift and have to stay positive ints
+	static constexpr std::uint64_t kMaxVertexIds = 1ull << 30;
+	// one DrawRecord
+	static constexpr std::size_t kTexelsPerDraw = 4;
+	// begin() looks for unused geometry this often, compacting once half of it is dead
+	static constexpr std::uint64_t kGeometryCheckPasses = 256;
+
+	static const UniformId kTexUniform = UniformId::of("uTex");
+	static const UniformId kGeometryUniform = UniformId::of("uGeometry");
+	static const UniformId kDrawsUniform = UniformId::of("uDraws");
+	static const UniformId kDrawShiftUniform = UniformId::of("uDrawShift");
+
+	static int shiftFor(int vertexCount) {
+		int shift = 0;
+		while ((1 << shift) < vertexCount) ++shift;
+		return shift;
+	}
+
+	MeshBatcher::~MeshBatcher() {
+		GLStateTracker& gl = glState();
+		gl.forgetTexture(m_geometryTex);
+		gl.forgetTexture(m_drawTex);
+		gl.forgetVertexArray(m_vao);
+		gl.forgetBuffer(m_geometryBuffer);
+		gl.forgetBuffer(m_drawBuffer);
+		if (m_geometryTex) glDeleteTextures(1, &m_geometryTex);
+		if (m_drawTex) glDeleteTextures(1, &m_drawTex);
+		if (m_geometryBuffer) glDeleteBuffers(1, &m_geometryBuffer);
+		if (m_drawBuffer) glDeleteBuffers(1, &m_drawBuffer);
+		if (m_vao) glDeleteVertexArrays(1, &m_vao);
+	}
+
+	void MeshBatcher::initGL() {
+		if (m_inited) return;
+
+		GLint maxTexels = 0;
+		glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+		if (maxTexels > 0) m_maxTexels = maxTexels;
+
+		glGenVertexArrays(1, &m_vao);
+
+		glGenBuffers(1, &m_geometryBuffer);
+		glGenBuffers(1, &m_drawBuffer);
+		glState().bindBuffer(GL_TEXTURE_BUFFER, m_geometryBuffer);
+		glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STATIC_DRAW);
+		glState().bindBuffer(GL_TEXTURE_BUFFER, m_drawBuffer);
+		glBufferData(GL_TEXTURE_BUFFER, 16, nullptr, GL_STREAM_DRAW);
+
+		glGenTextures(1, &m_geometryTex);
+		glState().bindTexture(GL_TEXTURE_BUFFER, m_geometryTex);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_geometryBuffer);
+		glGenTextures(1, &m_drawTex);
+		glState().bindTexture(GL_TEXTURE_BUFFER, m_drawTex);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_drawBuffer);
+		glState().bindTexture(GL_TEXTURE_BUFFER, 0);
+
+		m_inited = true;
+	}
+
+	void MeshBatcher::begin(StatsSink sink) {
+		m_sink = sink;
+		m_hasBatch = false;
+		m_maxVertexCount = 0;
+		m_draws.clear();
+		m_counts.clear();
+
+		m_pass++;
+		if (m_geometryFull) {
+			m_geometryFull = false;
+			compactGeometry();
+		} else if (m_pass % kGeometryCheckPasses == 0) {
+			std::size_t dead = 0;
+			for (const auto& kv : m_meshFirst) {
+				if (m_pass - kv.second.lastPass > kGeometryKeepPasses) dead += kv.second.count;
+			}
+			if (dead > 0 && dead * 2 >= geometryVertices()) compactGeometry();
+		}
+	}
+
+	void MeshBatcher::compactGeometry() {
+		std::vector<float> packed;
+		packed.reserve(m_geometry.size());
+		for (auto it = m_meshFirst.begin(); it != m_meshFirst.end();) {
+			GeometryEntry& e = it->second;
+			if (m_pass - e.lastPass > kGeometryKeepPasses) {
+				it = m_meshFirst.erase(it);
+				continue;
+			}
+			const auto src = m_geometry.begin() + (std::ptrdiff_t)e.first * 4;
+			e.first = (std::uint32_t)(packed.size() / 4);
+			packed.insert(packed.end(), src, src + (std::ptrdiff_t)e.count * 4);
+			++it;
+		}
+		if (packed.size() == m_geometry.size()) return; // nothing was dead
+
+		m_geometry.swap(packed);
+		m_geometryUploaded = 0;
+		m_geometryDirty = true;
+		m_geometryCompactions++;
+	}
+
+	bool MeshBatcher::canBatch(const Mesh* mesh, const Material2D& material) const {
+		return m_batchShaders && m_materialShaders && material.permutations == m_materialShaders &&
+			   mesh && mesh->vertexCount() > 0;
+	}
+
+	bool MeshBatcher::geometryFirst(const Mesh& mesh, std::uint32_t& first) {
+		auto it = m_meshFirst.find(mesh.uid());
+		if (it != m_meshFirst.end()) {
+			it->second.lastPass = m_pass;
+			first = it->second.first;
+			return true;
+		}
+
+		const std::size_t vertices = geometryVertices();
+		const std::size_t count = (std::size_t)mesh.vertexCount();
+		// positions past 2^24 no longer survive the float in DrawRecord
+		if (vertices + count > (std::size_t)m_maxTexels || vertices + count > (1u << 24)) {
+			m_geometryFull = true;
+			if (m_sink.batchFallbacks) (*m_sink.batchFallbacks)++;
+			return false;
+		}
+
+		first = (std::uint32_t)vertices;
+		const std::vector<float>& src = mesh.vertices();
+		m_geometry.insert(m_geometry.end(), src.begin(), src.begin() + count * 4);
+		m_meshFirst.emplace(mesh.uid(), GeometryEntry{ first, (std::uint32_t)count, m_pass });
+		m_geometryDirty = true;
+		return true;
+	}
+
+	bool MeshBatcher::submit(const Mesh& mesh, const Material2D& material, const Affine2D& model,
+							 const Vec4& tint, const Vec4& uvRect, GLStateTracker& st) {
+		initGL();
+
+		std::uint32_t first = 0;
+		if (!geometryFirst(mesh, first)) return false;
+
+		const Shader* shader = m_batchShaders->variant(material.shaderFeatures());
+		if (!shader) return false;
+
+		// one variant and texture per batch; the renderer's sort keeps them together
+		const Texture2D* tex = material.textured() ? material.texture : nullptr;
+		if (m_hasBatch && (shader != m_batchShader || tex != m_batchTexture)) flushInternal(st);
+
+		// vertex ids of the whole batch, or the per-draw texels, would overflow
+		const int maxCount = std::max(m_maxVertexCount, mesh.vertexCount());
+		const std::uint64_t ids = (std::uint64_t)(m_draws.size() + 1) << shiftFor(maxCount);
+		const std::size_t texels = (m_draws.size() + 1) * kTexelsPerDraw;
+		if (m_hasBatch && (ids > kMaxVertexIds || texels > (std::size_t)m_maxTexels)) flushInternal(st);
+
+		if (!m_hasBatch) {
+			m_hasBatch = true;
+			m_batchShader = shader;
+			m_batchTexture = tex;
+		}
+
+		DrawRecord d;
+		d.linear[0] = model.a;
+		d.linear[1] = model.b;
+		d.linear[2] = model.c;
+		d.linear[3] = model.d;
+		d.translate[0] = model.tx;
+		d.translate[1] = model.ty;
+		d.firstVertex = (float)first;
+		d.pad = 0.0f;
+		d.color[0] = material.color.r * tint.r;
+		d.color[1] = material.color.g * tint.g;
+		d.color[2] = material.color.b * tint.b;
+		d.color[3] = material.color.a * tint.a;
+		d.uvRect[0] = uvRect.r;
+		d.uvRect[1] = uvRect.g;
+		d.uvRect[2] = uvRect.b;
+		d.uvRect[3] = uvRect.a;
+		m_draws.push_back(d);
+		m_counts.push_back(mesh.vertexCount());
+		m_maxVertexCount = std::max(m_maxVertexCount, mesh.vertexCount());
+		return true;
+	}
+
+	void MeshBatcher::flush(GLStateTracker& st) {
+		if (!m_hasBatch) return;
+		flushInternal(st);
+	}
+
+	void MeshBatcher::bindShader(GLStateTracker& st) {
+		const Shader& shader = *m_batchShader;
+		if (st.useProgram(shader.id())) {
+			shader.setInt(kTexUniform, 0);
+			shader.setInt(kGeometryUniform, kGeometryUnit);
+			shader.setInt(kDrawsUniform, kDrawUnit);
+			if (m_sink.shaderBinds) (*m_sink.shaderBinds)++;
+		}
+	}
+
+	void MeshBatcher::uploadGeometry() {
+		const std::size_t bytes = m_geometry.size() * sizeof(float);
+		glState().bindBuffer(GL_TEXTURE_BUFFER, m_geometryBuffer);
+		// grown, or compacted: fresh storage (orphans the old one), mirror from the start
+		if (bytes > m_geometryBufferBytes || m_geometryUploaded == 0) {
+			const std::size_t maxBytes = (std::size_t)m_maxTexels * 4 * sizeof(float);
+			if (bytes > m_geometryBufferBytes) m_geometryBufferBytes = std::max(bytes, std::min(m_geometryBufferBytes * 2, maxBytes));
+			glBufferData(GL_TEXTURE_BUFFER, (GLsizeiptr)m_geometryBufferBytes, nullptr, GL_STATIC_DRAW);
+			m_geometryUploaded = 0;
+		}
+		// only the meshes appended since the last upload
+		glBufferSubData(GL_TEXTURE_BUFFER, (GLintptr)(m_geometryUploaded * sizeof(float)),
+						(GLsizeiptr)(bytes - m_geometryUploaded * sizeof(float)), m_geometry.data() + m_geometryUploaded);
+		m_geometryUploaded = m_geometry.size();
+		m_geometryDirty = false;
+	}
+
+	void MeshBatcher::flushInternal(GLStateTracker& st) {
+		const std::size_t n = m_draws.size();
+		m_hasBatch = false;
+		if (n == 0) return;
+
+		if (m_geometryDirty) uploadGeometry();
+
+		// orphan, then fill: the previous batch may still be in flight
+		const std::size_t bytes = n * sizeof(DrawRecord);
+		st.bindBuffer(GL_TEXTURE_BUFFER, m_drawBuffer);
+		if (bytes > m_drawBufferBytes) m_drawBufferBytes = std::max(bytes, m_drawBufferBytes * 2);
+		glBufferData(GL_TEXTURE_BUFFER, (GLsizeiptr)m_drawBufferBytes, nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_TEXTURE_BUFFER, 0, (GLsizeiptr)bytes, m_draws.data());
+
+		bindShader(st);
+		const int shift = shiftFor(m_maxVertexCount);
+		m_batchShader->setInt(kDrawShiftUniform, shift);
+
+		if (m_batchTexture && st.bindTexture(0, GL_TEXTURE_2D, m_batchTexture->id())) {
+			if (m_sink.textureBinds) (*m_sink.textureBinds)++;
+		}
+		// the buffer textures stay bound on their units across flushes and passes
+		st.bindTexture(kGeometryUnit, GL_TEXTURE_BUFFER, m_geometryTex);
+		st.bindTexture(kDrawUnit, GL_TEXTURE_BUFFER, m_drawTex);
+
+		if (st.bindVertexArray(m_vao)) {
+			if (m_sink.vaoBinds) (*m_sink.vaoBinds)++;
+		}
+
+		m_firsts.resize(n);
+		std::uint32_t verts = 0;
+		for (std::size_t k = 0; k < n; ++k) {
+			m_firsts[k] = (std::int32_t)(k << shift);
+			verts += (std::uint32_t)m_counts[k];
+		}
+		glMultiDrawArrays(GL_TRIANGLES, m_firsts.data(), m_counts.data(), (GLsizei)n);
+
+		if (m_sink.drawCalls) (*m_sink.drawCalls)++;
+		if (m_sink.batchFlushes) (*m_sink.batchFlushes)++;
+		if (m_sink.batchedVerts) (*m_sink.batchedVerts) += verts;
+		if (m_sink.batchedMeshes) (*m_sink.batchedMeshes) += (std::uint32_t)n;
+
+		m_draws.clear();
+		m_counts.clear();
+		m_maxVertexCount = 0;
+	}
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "math/affine2d.h"
+#include "renderer/material2d.h"
+#include "renderer/gl_state_tracker.h"
+
+namespace argon {
+
+	class Mesh;
+	class Shader;
+	class ShaderPermutations;
+	class Texture2D;
+
+	// Batches meshes that are not instanced sprites. Every mesh is copied once
+	// into a shared geometry buffer (the engine vertex format, x y u v); each draw
+	// appends its transform, color and uv rect to a per-draw buffer, and a batch
+	// goes out as one glMultiDrawArrays. The vertex shader reads both buffers
+	// through texture buffers.
+	//
+	// GL 3.3 has no gl_DrawID, so draw k starts at vertex id k << shift, where
+	// 1 << shift covers the largest mesh in the batch: the shader splits
+	// gl_VertexID into draw index and mesh vertex, and fetches the vertex from
+	// the mesh's first vertex in the geometry buffer. No vertex attributes are
+	// used.
+	//
+	// Batch program inputs: samplerBuffer uGeometry and uDraws, int uDrawShift,
+	// the PassConstants block, plus sampler2D uTex in textured variants. A
+	// material batches with the batch variant of its own feature mask.
+	// One uDraws record is 4 texels: (a, b, c, d), (tx, ty, firstVertex, 0),
+	// color, uvRect.
+	class MeshBatcher {
+	public:
+		// texture buffer units, above the ones sprite batches spread over
+		static constexpr int kGeometryUnit = GLStateTracker::kTextureUnits;
+		static constexpr int kDrawUnit = GLStateTracker::kTextureUnits + 1;
+		// passes a mesh may go undrawn before its geometry can be reclaimed
+		static constexpr std::uint64_t kGeometryKeepPasses = 600;
+
+		struct StatsSink {
+			std::uint32_t* drawCalls = nullptr;
+			std::uint32_t* shaderBinds = nullptr;
+			std::uint32_t* textureBinds = nullptr;
+			std::uint32_t* vaoBinds = nullptr;
+			std::uint32_t* batchFlushes = nullptr;
+			std::uint32_t* batchedVerts = nullptr;
+			std::uint32_t* batchedMeshes = nullptr;
+			std::uint32_t* batchFallbacks = nullptr; // meshes left unbatched, geometry buffer full
+		};
+
+		MeshBatcher() = default;
+		~MeshBatcher();
+
+		MeshBatcher(const MeshBatcher&) = delete;
+		MeshBatcher& operator=(const MeshBatcher&) = delete;
+
+		// materials built from materialShaders are drawn with the batchShaders
+		// variant of the same features when batched
+		void setShaders(const ShaderPermutations* materialShaders, ShaderPermutations* batchShaders) {
+			m_materialShaders = materialShaders;
+			m_batchShaders = batchShaders;
+		}
+
+		void begin(StatsSink sink);
+		bool canBatch(const Mesh* mesh, const Material2D& material) const;
+		// false when the mesh does not fit the geometry buffer; draw it unbatched.
+		// Space held by meshes not drawn for kGeometryKeepPasses passes is
+		// reclaimed at the next begin() after that happens.
+		bool submit(const Mesh& mesh, const Material2D& material, const Affine2D& model,
+					const Vec4& tint, const Vec4& uvRect, GLStateTracker& st);
+		void flush(GLStateTracker& st);
+
+		std::size_t geometryVertices() const { return m_geometry.size() / 4; }
+		std::uint32_t geometryCompactions() const { return m_geometryCompactions; }
+
+	private:
+		struct DrawRecord {
+			float linear[4];     // a, b, c, d
+			float translate[2];
+			float firstVertex;   // exact up to 2^24 vertices
+			float pad;
+			float color[4];
+			float uvRect[4];
+		};
+		static_assert(sizeof(DrawRecord) == 64, "a draw record is four RGBA32F texels");
+
+		struct GeometryEntry {
+			std::uint32_t first = 0;    // vertex
+			std::uint32_t count = 0;
+			std::uint64_t lastPass = 0; // pass it was last drawn in
+		};
+
+		void initGL();
+		// first vertex of mesh in the geometry buffer, appending it on first use
+		bool geometryFirst(const Mesh& mesh, std::uint32_t& first);
+		// drops meshes unused for kGeometryKeepPasses and packs the rest to the front;
+		// only between batches, open draw records hold first vertices
+		void compactGeometry();
+		void uploadGeometry();
+		void bindShader(GLStateTracker& st);
+		void flushInternal(GLStateTracker& st);
+
+	private:
+		// per-pass
+		StatsSink m_sink{};
+
+		// open batch; all draws share the variant and the material texture
+		bool m_hasBatch = false;
+		const Shader* m_batchShader = nullptr;
+		const Texture2D* m_batchTexture = nullptr;
+		int m_maxVertexCount = 0;
+		std::vector<DrawRecord> m_draws;
+		std::vector<std::int32_t> m_firsts;  // GLint
+		std::vector<std::int32_t> m_counts;  // GLsizei
+
+		// shared geometry; new meshes are appended to the CPU mirror and only the
+		// appended range is uploaded, compaction re-uploads it whole
+		std::unordered_map<std::uint64_t, GeometryEntry> m_meshFirst; // Mesh::uid -> placement
+		std::vector<float> m_geometry;
+		std::size_t m_geometryUploaded = 0;   // floats of m_geometry already in the buffer
+		std::size_t m_geometryBufferBytes = 0;
+		std::uint64_t m_pass = 0;
+		bool m_geometryDirty = false;
+		bool m_geometryFull = false;          // a mesh did not fit: compact at the next begin()
+		std::uint32_t m_geometryCompactions = 0;
+
+		// GL
+		bool m_inited = false;
+		int m_maxTexels = 65536;   // GL_MAX_TEXTURE_BUFFER_SIZE
+		unsigned int m_vao = 0;    // no attributes, everything is fetched
+		unsigned int m_geometryBuffer = 0;
+		unsigned int m_geometryTex = 0;
+		unsigned int m_drawBuffer = 0;
+		unsigned int m_drawTex = 0;
+		std::size_t m_drawBufferBytes = 0;
+
+		const ShaderPermutations* m_materialShaders = nullptr;
+		ShaderPermutations* m_batchShaders = nullptr;
+	};
+}
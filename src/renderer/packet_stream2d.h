@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "core/frame_arena.h"
+#include "renderer/render_packet2d.h"
+
+namespace argon {
+
+	// Read-only window onto a packet stream; keys[i] is the renderer sort key
+	// of packets[i]. Points into the stream, so it is valid until the stream
+	// is cleared or grows.
+	struct PacketView2D {
+		const RenderPacket2D* packets = nullptr;
+		const std::uint64_t* keys = nullptr;
+		std::size_t count = 0;
+
+		bool empty() const { return count == 0; }
+		std::size_t size() const { return count; }
+		const RenderPacket2D& operator[](std::size_t i) const { return packets[i]; }
+		const RenderPacket2D* begin() const { return packets; }
+		const RenderPacket2D* end() const { return packets + count; }
+	};
+
+	// The visible packets of one frame, written once (RenderSystem2D::buildPackets)
+	// and read by every pass through view(): the renderer sorts (key, index)
+	// pairs into it instead of copying packets into its queue. Keys sit in their
+	// own array so building the sort items reads 8 bytes per packet.
+	// Only visible packets with a mesh are recorded.
+	class PacketStream2D {
+	public:
+		// empties the stream and moves its storage onto arena's current frame
+		void rebind(FrameArena* arena) {
+			rebindFrameVector(m_packets, arena);
+			rebindFrameVector(m_keys, arena);
+		}
+
+		void clear() {
+			m_packets.clear();
+			m_keys.clear();
+		}
+
+		void reserve(std::size_t n) {
+			m_packets.reserve(n);
+			m_keys.reserve(n);
+		}
+
+		void push(const RenderPacket2D& pkt, std::uint64_t key) {
+			m_packets.push_back(pkt);
+			m_keys.push_back(key);
+		}
+
+		// for writers that fill disjoint ranges in parallel
+		void resize(std::size_t n) {
+			m_packets.resize(n);
+			m_keys.resize(n);
+		}
+		RenderPacket2D* packets() { return m_packets.data(); }
+		std::uint64_t* keys() { return m_keys.data(); }
+
+		std::size_t size() const { return m_packets.size(); }
+		bool empty() const { return m_packets.empty(); }
+
+		PacketView2D view() const { return { m_packets.data(), m_keys.data(), m_packets.size() }; }
+
+	private:
+		FrameVector<RenderPacket2D> m_packets;
+		FrameVector<std::uint64_t> m_keys;
+	};
+}
@@ -0,0 +1,21 @@
+#include "renderer/pass_constants.h"
+#include "renderer/gl_state_tracker.h"
+#include <glad/glad.h>
+
+namespace argon {
+
+	PassUniformBuffer::~PassUniformBuffer() {
+		glState().forgetBuffer(m_buffer);
+		if (m_buffer) glDeleteBuffers(1, &m_buffer);
+	}
+
+	void PassUniformBuffer::upload(const PassConstants2D& constants) {
+		if (!m_buffer) glGenBuffers(1, &m_buffer);
+
+		// both binds stay current from pass to pass, only the first reaches GL
+		GLStateTracker& st = glState();
+		st.bindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(PassConstants2D), &constants, GL_STREAM_DRAW);
+		st.bindUniformBufferBase(kPassConstantsBinding, m_buffer);
+	}
+}
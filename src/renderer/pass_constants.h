@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+
+// GLSL declaration of the per-pass block, for engine shaders to paste after
+// their #version line. Matches PassConstants2D below.
+#define ARGON_PASS_CONSTANTS_GLSL                                   \
+	"layout(std140) uniform PassConstants {\n"                      \
+	"	mat4 uPV;\n"                                                \
+	"	vec4 uViewport; // x, y, width, height in pixels\n"         \
+	"	vec4 uTime;     // seconds, frame delta, 0, 0\n"            \
+	"};\n"
+
+namespace argon {
+
+	// Uniform buffer binding point of the PassConstants block. Shader links the
+	// block to it when the program declares one, so binding the buffer once per
+	// pass serves every program switch in between.
+	static constexpr std::uint32_t kPassConstantsBinding = 0;
+
+	// std140 mirror of the PassConstants block
+	struct PassConstants2D {
+		float PV[16];       // column-major
+		float viewport[4];
+		float time[4];
+	};
+	static_assert(sizeof(PassConstants2D) == 96, "PassConstants2D must match the std140 block");
+
+	// The uniform buffer behind the block. upload() orphans the storage, so a
+	// pass can overwrite constants the previous pass's draws still read.
+	class PassUniformBuffer {
+	public:
+		PassUniformBuffer() = default;
+		~PassUniformBuffer();
+
+		PassUniformBuffer(const PassUniformBuffer&) = delete;
+		PassUniformBuffer& operator=(const PassUniformBuffer&) = delete;
+
+		// uploads and binds to kPassConstantsBinding
+		void upload(const PassConstants2D& constants);
+
+	private:
+		unsigned int m_buffer = 0;
+	};
+}
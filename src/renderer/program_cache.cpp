@@ -0,0 +1,171 @@
+#include "renderer/program_cache.h"
+#include "renderer/gl_extensions.h"
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+namespace argon {
+
+	namespace {
+		constexpr std::uint32_t kMagic = 0x42504741; // "AGPB"
+		constexpr std::uint32_t kVersion = 1;
+
+		struct EntryHeader {
+			std::uint32_t magic;
+			std::uint32_t version;
+			std::uint64_t key;
+			std::uint32_t format;   // GLenum binary format
+			std::uint32_t length;   // bytes of binary following the header
+			double compileMs;       // what building it from source cost
+		};
+		static_assert(sizeof(EntryHeader) == 32, "EntryHeader is written as is");
+
+		std::string s_dir;
+		ProgramCacheStats s_stats;
+
+		double msSince(std::chrono::high_resolution_clock::time_point t0) {
+			return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+		}
+
+		void hashBytes(std::uint64_t& h, const char* s) {
+			// FNV-1a, terminator included so "ab"+"c" and "a"+"bc" differ
+			if (s) {
+				for (; *s; ++s) {
+					h ^= (std::uint8_t)*s;
+					h *= 0x100000001b3ull;
+				}
+			}
+			h *= 0x100000001b3ull; // the 0 byte
+		}
+
+		std::string entryPath(std::uint64_t key) {
+			char name[32];
+			std::snprintf(name, sizeof(name), "%016llx.glbin", (unsigned long long)key);
+			return (std::filesystem::path(s_dir) / name).string();
+		}
+	}
+
+	void setProgramCacheDirectory(const std::string& dir) {
+		s_dir = dir;
+	}
+
+	const std::string& programCacheDirectory() {
+		return s_dir;
+	}
+
+	bool programCacheEnabled() {
+		return !s_dir.empty() && glExt().programBinary;
+	}
+
+	const ProgramCacheStats& programCacheStats() {
+		return s_stats;
+	}
+
+	void resetProgramCacheStats() {
+		s_stats = ProgramCacheStats{};
+	}
+
+	std::uint64_t programCacheKey(const char* vsSrc, const char* fsSrc) {
+		std::uint64_t h = 0xcbf29ce484222325ull ^ kVersion;
+		hashBytes(h, vsSrc);
+		hashBytes(h, fsSrc);
+		hashBytes(h, (const char*)glGetString(GL_VENDOR));
+		hashBytes(h, (const char*)glGetString(GL_RENDERER));
+		hashBytes(h, (const char*)glGetString(GL_VERSION));
+		return h;
+	}
+
+	void hintProgramRetrievable(GLuint program) {
+		if (!programCacheEnabled()) return;
+		glExt().ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+
+	GLuint loadCachedProgram(std::uint64_t key) {
+		if (!programCacheEnabled()) return 0;
+		const auto t0 = std::chrono::high_resolution_clock::now();
+
+		std::ifstream in(entryPath(key), std::ios::binary);
+		if (!in) {
+			s_stats.misses++;
+			return 0;
+		}
+
+		EntryHeader h{};
+		std::vector<char> binary;
+		bool valid = (bool)in.read((char*)&h, sizeof(h)) &&
+					 h.magic == kMagic && h.version == kVersion && h.key == key && h.length > 0;
+		if (valid) {
+			binary.resize(h.length);
+			valid = (bool)in.read(binary.data(), (std::streamsize)h.length);
+		}
+		if (!valid) {
+			std::cerr << "Ignoring corrupt program cache entry: " << entryPath(key) << "\n";
+			s_stats.misses++;
+			return 0;
+		}
+
+		GLuint prog = glCreateProgram();
+		glExt().ProgramBinary(prog, (GLenum)h.format, binary.data(), (GLsizei)h.length);
+		GLint ok = 0;
+		glGetProgramiv(prog, GL_LINK_STATUS, &ok);
+		if (!ok) {
+			// the driver changed under an unchanged version string, or the blob is stale
+			glDeleteProgram(prog);
+			s_stats.rejected++;
+			s_stats.misses++;
+			return 0;
+		}
+
+		const double ms = msSince(t0);
+		s_stats.hits++;
+		s_stats.loadMs += ms;
+		if (h.compileMs > ms) s_stats.savedMs += h.compileMs - ms;
+		return prog;
+	}
+
+	void storeCachedProgram(std::uint64_t key, GLuint program, double compileMs) {
+		s_stats.compileMs += compileMs;
+		if (!programCacheEnabled() || !program) return;
+
+		GLint length = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0) return;
+
+		std::vector<char> binary((std::size_t)length);
+		GLenum format = 0;
+		GLsizei written = 0;
+		glExt().GetProgramBinary(program, length, &written, &format, binary.data());
+		if (written <= 0) return;
+
+		std::error_code ec;
+		std::filesystem::create_directories(s_dir, ec);
+		if (ec) {
+			std::cerr << "Failed to create program cache directory " << s_dir << ": " << ec.message() << "\n";
+			return;
+		}
+
+		// write aside and rename, so a crash never leaves a truncated entry behind
+		const std::string path = entryPath(key);
+		const std::string tmp = path + ".tmp";
+		{
+			std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+			const EntryHeader h{ kMagic, kVersion, key, (std::uint32_t)format, (std::uint32_t)written, compileMs };
+			out.write((const char*)&h, sizeof(h));
+			out.write(binary.data(), written);
+			if (!out) {
+				std::cerr << "Failed to write program cache entry: " << tmp << "\n";
+				return;
+			}
+		}
+		std::filesystem::rename(tmp, path, ec);
+		if (ec) {
+			std::filesystem::remove(tmp, ec);
+			return;
+		}
+		s_stats.stores++;
+	}
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <glad/glad.h>
+
+namespace argon {
+
+	// On-disk cache of linked program binaries (glGetProgramBinary /
+	// glProgramBinary). Shader consults it before compiling: a program is keyed
+	// by a hash of both sources plus GL_VENDOR, GL_RENDERER and GL_VERSION, so a
+	// driver update or a different GPU misses instead of loading a stale blob.
+	// Binaries the driver refuses are recompiled and overwritten.
+	//
+	// Off until a directory is set, and a no-op when the driver exposes no
+	// binary formats (see GLExtensions::programBinary). GL thread only.
+	struct ProgramCacheStats {
+		std::uint32_t hits = 0;
+		std::uint32_t misses = 0;    // no usable entry, compiled from source
+		std::uint32_t rejected = 0;  // entry found but refused by the driver, counted in misses too
+		std::uint32_t stores = 0;
+		double loadMs = 0.0;         // reading and loading hits
+		double compileMs = 0.0;      // compiling and linking misses
+		// compile time recorded with each hit's entry, minus what loading it took
+		double savedMs = 0.0;
+	};
+
+	// creates dir on first store; empty disables the cache
+	void setProgramCacheDirectory(const std::string& dir);
+	const std::string& programCacheDirectory();
+	bool programCacheEnabled();
+
+	const ProgramCacheStats& programCacheStats();
+	void resetProgramCacheStats();
+
+	// used by Shader
+	std::uint64_t programCacheKey(const char* vsSrc, const char* fsSrc);
+	// before glLinkProgram, so the driver keeps a retrievable binary
+	void hintProgramRetrievable(GLuint program);
+	// a linked program, or 0 on a miss
+	GLuint loadCachedProgram(std::uint64_t key);
+	void storeCachedProgram(std::uint64_t key, GLuint program, double compileMs);
+}
@@ -1,31 +1,46 @@
 #pragma once
-#include <vector>
 #include "math/mat4.h"
-#include "renderer/render_packet2d.h"
+#include "renderer/material2d.h"
+#include "renderer/packet_stream2d.h"
 
 namespace argon {
 
 	class Scene;
 	class Camera2D;
 	class MaterialLibrary;
-	
-	// when render time <= 1, direct draw
+	class FrameArena;
+
+	// Direct: every world pass culls and submits on its own.
+	// Record: the world is culled once into RenderFrame2D::packets and every
+	// pass submits a view of it.
+	// Auto: RenderPipeline2D picks per frame from the passes and measured cost.
 	enum class FrameMode {Auto = 0, Direct, Record};
 
 	struct RenderFrame2D {
-		
+
+		// what the application asks for; a pass that needs packets forces Record
+		FrameMode requestedMode = FrameMode::Auto;
+		// resolved by RenderPipeline2D::execute, never Auto while passes run
 		FrameMode mode = FrameMode::Direct;
 
 		Mat4 PV = Mat4::identity();
 		const MaterialLibrary* matlib = nullptr;
+		// PassConstants block inputs besides PV
+		Vec4 viewport{ 0.0f, 0.0f, 0.0f, 0.0f }; // x, y, width, height in pixels
+		float time = 0.0f;
+		float dt = 0.0f;
 
 		// direct path inputs
 		const Scene* scene = nullptr;
 		const Camera2D* cam = nullptr;
 		float aspect = 1.0f;
 
-		std::vector<RenderPacket2D> packets;
+		// optional: packets live in this arena (started by the application)
+		FrameArena* arena = nullptr;
+
+		// record path output, keyed against matlib
+		PacketStream2D packets;
 		void clearPackets() { packets.clear(); }
 	};
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,82 @@
+#include "renderer/render_ids.h"
+#include "renderer/renderer.h"
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+namespace argon {
+
+	namespace {
+		struct IdPool {
+			std::vector<std::uint32_t> freeIds;
+			std::uint32_t next = 1;
+			std::uint32_t live = 0;
+			bool warned = false;
+		};
+
+		struct IdPools {
+			std::mutex mutex;
+			IdPool pools[(int)RenderIdKind::Count];
+		};
+
+		IdPools& idPools() {
+			static IdPools s;
+			return s;
+		}
+
+		const char* kindName(RenderIdKind kind) {
+			switch (kind) {
+			case RenderIdKind::Shader: return "shader";
+			case RenderIdKind::Texture: return "texture";
+			case RenderIdKind::Mesh: return "mesh";
+			default: return "unknown";
+			}
+		}
+	}
+
+	std::uint32_t RenderIds::capacity(RenderIdKind kind) {
+		switch (kind) {
+		case RenderIdKind::Shader: return Renderer::SortKey::kShaderMax;
+		case RenderIdKind::Texture: return Renderer::SortKey::kTextureMax;
+		case RenderIdKind::Mesh: return Renderer::SortKey::kMeshMax;
+		default: return 0;
+		}
+	}
+
+	std::uint32_t RenderIds::acquire(RenderIdKind kind) {
+		IdPools& s = idPools();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		IdPool& p = s.pools[(int)kind];
+
+		std::uint32_t id = 0;
+		if (!p.freeIds.empty()) {
+			id = p.freeIds.back();
+			p.freeIds.pop_back();
+		} else {
+			id = p.next++;
+		}
+		p.live++;
+
+		if (id > capacity(kind) && !p.warned) {
+			p.warned = true;
+			std::cerr << "[RenderIds] more than " << capacity(kind) << " live " << kindName(kind)
+					  << " resources, sort keys will alias (draws stay correct, state grouping degrades)\n";
+		}
+		return id;
+	}
+
+	void RenderIds::release(RenderIdKind kind, std::uint32_t id) {
+		if (id == 0) return;
+		IdPools& s = idPools();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		IdPool& p = s.pools[(int)kind];
+		p.freeIds.push_back(id);
+		if (p.live) p.live--;
+	}
+
+	std::uint32_t RenderIds::liveCount(RenderIdKind kind) {
+		IdPools& s = idPools();
+		std::lock_guard<std::mutex> lock(s.mutex);
+		return s.pools[(int)kind].live;
+	}
+}
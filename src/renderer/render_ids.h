@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+namespace argon {
+
+	enum class RenderIdKind : std::uint8_t { Shader = 0, Texture, Mesh, Count };
+
+	// Dense engine ids for GL resources, used in sort keys instead of raw GL names.
+	// Ids start at 1 (0 = none) and are recycled when the resource dies, so they
+	// stay bounded by the number of live resources no matter how many GL objects
+	// a session creates and destroys.
+	class RenderIds {
+	public:
+		static std::uint32_t acquire(RenderIdKind kind);
+		static void release(RenderIdKind kind, std::uint32_t id);
+
+		// largest id a sort key can hold for this kind
+		static std::uint32_t capacity(RenderIdKind kind);
+		static std::uint32_t liveCount(RenderIdKind kind);
+	};
+}
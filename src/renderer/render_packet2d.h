@@ -1,6 +1,7 @@
 #pragma once
 #include <cstdint>
-#include "math/mat4.h"
+#include "math/affine2d.h"
+#include "math/transform.h"
 #include "renderer/material_handle.h"
 #include "renderer/material2d.h"
 
@@ -11,8 +12,13 @@ namespace argon {
 	struct RenderPacket2D {
 		const Mesh* mesh = nullptr;
 		MaterialHandle material = {};
-		Mat4 model = Mat4::identity();
+		Affine2D model;
+		// set instead of model when Renderer::expandsTransformOnGpu(mesh): the
+		// instanced sprite shader builds the model from these fields
+		Transform trs;
+		bool gpuTransform = false;
 		std::int32_t layer = 0;
+		std::uint16_t depth = 0; // optional draw order inside a layer+state group (10 bits used)
 		bool visible = true;
 		Vec4 tint{ 1.0f,1.0f,1.0f,1.0f };
 		Vec4 uvRect{ 0.0f,0.0f,1.0f,1.0f }; // (u0,v0,u1,v1)
@@ -10,17 +10,23 @@ namespace argon {
 		Renderer::PassContext2D ctx;
 		ctx.PV = frame.PV;
 		ctx.matlib = frame.matlib;
+		ctx.viewport = frame.viewport;
+		ctx.time = frame.time;
+		ctx.dt = frame.dt;
 
 		renderer.beginPass(ctx);
 
+		// baked background chunks, in both modes
+		if (frame.scene && frame.cam) {
+			m_rs.submitStatic(*frame.scene, renderer, *frame.cam, frame.aspect);
+		}
+
 		if (frame.mode == FrameMode::Direct) {
 			assert(frame.scene && frame.cam && "Direct mode needs scene+cam");
 			m_rs.submitVisible(*frame.scene, renderer, *frame.cam, frame.aspect);
 		} else {
-			for (const auto& pkt : frame.packets) {
-				if (!pkt.visible) continue;
-				renderer.submit(pkt);
-			}
+			// by reference: every world pass sorts into the same recorded packets
+			renderer.submit(frame.packets.view());
 		}
 
 		renderer.endPass();
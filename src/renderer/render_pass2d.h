@@ -17,12 +17,12 @@ namespace argon {
 
 	class WorldPass2D :public RenderPass2D {
 	public:
-		explicit WorldPass2D(const RenderSystem2D& rs) : m_rs(rs) {}
+		explicit WorldPass2D(RenderSystem2D& rs) : m_rs(rs) {}
 		bool needsWorld() const override { return true; }
 		bool needsWorldPackets() const override { return false; }
 		void execute(const RenderFrame2D& frame, Renderer& renderer) override;
 	
 	private:
-		const RenderSystem2D& m_rs;
+		RenderSystem2D& m_rs;
 	};
 }
\ No newline at end of file
@@ -2,9 +2,31 @@
 #include "systems/render_system2d.h"
 #include "renderer/render_frame2d.h"
 #include <cassert>
+#include <chrono>
 
 namespace argon {
-	
+
+	// weight of the newest frame in the smoothed per-mode cost
+	static constexpr float kCostSmoothing = 0.1f;
+
+	FrameMode RenderPipeline2D::chooseMode(const RenderFrame2D& frame, int worldPasses, int packetConsumers) {
+		m_stats.probe = false;
+		if (packetConsumers > 0) return FrameMode::Record;
+		if (frame.requestedMode != FrameMode::Auto) return frame.requestedMode;
+		// one world pass culls once either way, recording would only add a copy
+		if (worldPasses < 2) return FrameMode::Direct;
+
+		if (m_stats.directMs == 0.0f) return FrameMode::Direct;
+		if (m_stats.recordMs == 0.0f) return FrameMode::Record;
+
+		const FrameMode cheaper = m_stats.directMs <= m_stats.recordMs ? FrameMode::Direct : FrameMode::Record;
+		if (++m_framesSinceProbe < kProbeInterval) return cheaper;
+
+		// the scene changes under us: keep the other estimate fresh
+		m_framesSinceProbe = 0;
+		m_stats.probe = true;
+		return cheaper == FrameMode::Direct ? FrameMode::Record : FrameMode::Direct;
+	}
 
 	void RenderPipeline2D::execute(RenderFrame2D& frame, Renderer& renderer) {
 		assert(m_renderSys && "RenderPipeline2D: render system not set");
@@ -18,18 +40,33 @@ namespace argon {
 			if (p->needsWorldPackets()) packetConsumers++;
 		}
 
-		const bool needRecord = (packetConsumers > 0) || (worldPassCount >= 2);
-		frame.mode = needRecord ? FrameMode::Record : FrameMode::Direct;
-		
-		frame.clearPackets();
+		frame.mode = chooseMode(frame, worldPassCount, packetConsumers);
+		m_stats.mode = frame.mode;
+
+		using clock = std::chrono::steady_clock;
+		float worldMs = 0.0f;
+		auto t0 = clock::now();
+
+		if (frame.arena) frame.packets.rebind(frame.arena);
+		else frame.clearPackets();
 		if (frame.mode == FrameMode::Record) {
 			m_renderSys->buildPackets(*frame.scene, renderer, *frame.cam, frame.aspect, frame);
 		}
+		worldMs += std::chrono::duration<float, std::milli>(clock::now() - t0).count();
 
+		renderer.beginFrame();
 		for (auto& pass : m_passes) {
+			const bool world = pass->needsWorld();
+			if (world) t0 = clock::now();
 			pass->execute(frame, renderer);
+			if (world) worldMs += std::chrono::duration<float, std::milli>(clock::now() - t0).count();
 		}
+		renderer.endFrame();
 
+		// both modes pay the same submit and draw costs, so the totals compare
+		m_stats.worldMs = worldMs;
+		float& cost = frame.mode == FrameMode::Direct ? m_stats.directMs : m_stats.recordMs;
+		cost = cost == 0.0f ? worldMs : cost + (worldMs - cost) * kCostSmoothing;
 	}
 
-}
\ No newline at end of file
+}
@@ -2,15 +2,24 @@
 #include <memory>
 #include <vector>
 #include <cassert>
+#include <cstdint>
 #include "renderer/render_pass2d.h"
 
 namespace argon {
 	
-	class RenderFrame2D;
+	struct RenderFrame2D;
 	class RenderSystem2D;
 
 	class RenderPipeline2D {
 	public:
+		struct Stats {
+			FrameMode mode = FrameMode::Direct; // resolved mode of the last frame
+			float worldMs = 0.0f;               // packet build + world passes, last frame
+			// smoothed world cost per frame in each mode, 0 until measured
+			float directMs = 0.0f;
+			float recordMs = 0.0f;
+			bool probe = false;                 // last frame re-measured the costlier mode
+		};
 
 		RenderPipeline2D() = default;
 
@@ -26,10 +35,23 @@ namespace argon {
 			m_renderSys = renderSys;
 		}
 
+		// Resolves frame.mode from frame.requestedMode, then runs the passes.
+		// Auto: Record when a pass reads packets; Direct with a single world
+		// pass; otherwise whichever mode measured cheaper, with the other one
+		// re-measured every kProbeInterval frames.
 		void execute(RenderFrame2D& frame, Renderer& renderer);
 
+		const Stats& stats() const { return m_stats; }
+
+	private:
+		static constexpr std::uint32_t kProbeInterval = 120;
+
+		FrameMode chooseMode(const RenderFrame2D& frame, int worldPasses, int packetConsumers);
+
 	private:
 		std::vector<std::unique_ptr<RenderPass2D>> m_passes;
 		RenderSystem2D* m_renderSys = nullptr;
+		Stats m_stats;
+		std::uint32_t m_framesSinceProbe = 0;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,160 @@
+#include "renderer/render_sort.h"
+#include "core/thread_pool.h"
+#include <cstddef>
+#include <utility>
+
+namespace argon {
+
+	static constexpr int kDigitBits = 8;
+	static constexpr int kBuckets = 1 << kDigitBits;
+	static constexpr int kPasses = 64 / kDigitBits;
+
+	// below this a stable insertion sort beats clearing the histograms
+	static constexpr std::size_t kInsertionSortMax = 64;
+	// per-thread chunk size, below it the sync overhead outweighs the work
+	static constexpr std::size_t kParallelMinChunk = 16384;
+
+	static inline std::uint32_t digitOf(std::uint64_t key, int pass) {
+		return (std::uint32_t)(key >> (pass * kDigitBits)) & (kBuckets - 1);
+	}
+
+	static void insertionSort(SortItem* a, std::size_t n) {
+		for (std::size_t i = 1; i < n; ++i) {
+			const SortItem v = a[i];
+			std::size_t j = i;
+			while (j > 0 && a[j - 1].key > v.key) {
+				a[j] = a[j - 1];
+				--j;
+			}
+			a[j] = v;
+		}
+	}
+
+	// a pass is a no-op when every key has the same digit there
+	static bool isTrivialPass(const std::uint32_t* hist, std::size_t n) {
+		for (int d = 0; d < kBuckets; ++d) {
+			if (hist[d] == n) return true;
+			if (hist[d] != 0) return false;
+		}
+		return false;
+	}
+
+	void radixSortKeys(FrameVector<SortItem>& items, FrameVector<SortItem>& scratch) {
+		const std::size_t n = items.size();
+		if (n <= kInsertionSortMax) {
+			insertionSort(items.data(), n);
+			return;
+		}
+
+		std::uint32_t hist[kPasses][kBuckets] = {};
+		for (const SortItem& it : items) {
+			for (int p = 0; p < kPasses; ++p) {
+				hist[p][digitOf(it.key, p)]++;
+			}
+		}
+
+		scratch.resize(n);
+		SortItem* src = items.data();
+		SortItem* dst = scratch.data();
+
+		for (int p = 0; p < kPasses; ++p) {
+			if (isTrivialPass(hist[p], n)) continue;
+
+			std::uint32_t offset[kBuckets];
+			std::uint32_t sum = 0;
+			for (int d = 0; d < kBuckets; ++d) {
+				offset[d] = sum;
+				sum += hist[p][d];
+			}
+
+			for (std::size_t i = 0; i < n; ++i) {
+				const SortItem& it = src[i];
+				dst[offset[digitOf(it.key, p)]++] = it;
+			}
+			std::swap(src, dst);
+		}
+
+		if (src != items.data()) items.swap(scratch);
+	}
+
+	void radixSortKeysParallel(FrameVector<SortItem>& items, FrameVector<SortItem>& scratch,
+							   ThreadPool& pool) {
+		const std::size_t n = items.size();
+		const std::size_t chunks = pool.chunkCount(n, kParallelMinChunk);
+		if (chunks <= 1) {
+			radixSortKeys(items, scratch);
+			return;
+		}
+
+		scratch.resize(n);
+
+		// chunk-local histograms; chunk boundaries are identical for every
+		// parallelFor call with the same count, which keeps the scatter stable
+		FrameVector<std::uint32_t> chunkHist(chunks * kPasses * kBuckets, 0u, items.get_allocator());
+		auto histOf = [&](std::size_t chunk, int pass) {
+			return chunkHist.data() + (chunk * kPasses + (std::size_t)pass) * kBuckets;
+		};
+
+		// one read over the input finds the digits that need no pass at all
+		pool.parallelFor(n, kParallelMinChunk, [&](std::size_t begin, std::size_t end, std::size_t c) {
+			const SortItem* src = items.data();
+			for (std::size_t i = begin; i < end; ++i) {
+				for (int p = 0; p < kPasses; ++p) {
+					histOf(c, p)[digitOf(src[i].key, p)]++;
+				}
+			}
+		});
+
+		bool skip[kPasses];
+		for (int p = 0; p < kPasses; ++p) {
+			std::uint32_t total[kBuckets] = {};
+			for (std::size_t c = 0; c < chunks; ++c) {
+				const std::uint32_t* h = histOf(c, p);
+				for (int d = 0; d < kBuckets; ++d) total[d] += h[d];
+			}
+			skip[p] = isTrivialPass(total, n);
+		}
+
+		FrameVector<std::uint32_t> offsets(chunks * kBuckets, 0u, items.get_allocator());
+		SortItem* src = items.data();
+		SortItem* dst = scratch.data();
+		bool firstPass = true;
+
+		for (int p = 0; p < kPasses; ++p) {
+			if (skip[p]) continue;
+
+			// the first scattering pass can reuse the histograms of the initial read,
+			// later passes see a permuted source and need fresh chunk histograms
+			if (!firstPass) {
+				pool.parallelFor(n, kParallelMinChunk, [&](std::size_t begin, std::size_t end, std::size_t c) {
+					std::uint32_t* h = histOf(c, p);
+					for (int d = 0; d < kBuckets; ++d) h[d] = 0;
+					for (std::size_t i = begin; i < end; ++i) {
+						h[digitOf(src[i].key, p)]++;
+					}
+				});
+			}
+			firstPass = false;
+
+			// digit-major, chunk-minor prefix sum
+			std::uint32_t sum = 0;
+			for (int d = 0; d < kBuckets; ++d) {
+				for (std::size_t c = 0; c < chunks; ++c) {
+					offsets[c * kBuckets + d] = sum;
+					sum += histOf(c, p)[d];
+				}
+			}
+
+			pool.parallelFor(n, kParallelMinChunk, [&](std::size_t begin, std::size_t end, std::size_t c) {
+				std::uint32_t* off = offsets.data() + c * kBuckets;
+				for (std::size_t i = begin; i < end; ++i) {
+					const SortItem& it = src[i];
+					dst[off[digitOf(it.key, p)]++] = it;
+				}
+			});
+			std::swap(src, dst);
+		}
+
+		if (src != items.data()) items.swap(scratch);
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include "core/frame_arena.h"
+
+namespace argon {
+
+	class ThreadPool;
+
+	// compact (key, index) pair: the queue is sorted through these instead of
+	// moving the packets around
+	struct SortItem {
+		std::uint64_t key = 0;
+		std::uint32_t index = 0;
+	};
+
+	// Stable LSD radix sort (8-bit digits) on SortItem::key.
+	// Digits that are identical for every item are skipped.
+	// scratch is resized as needed; the result always ends up in items.
+	// Temporaries come from the allocator of items.
+	void radixSortKeys(FrameVector<SortItem>& items, FrameVector<SortItem>& scratch);
+
+	// Same result as radixSortKeys, histogram and scatter of each pass are split
+	// across the pool workers. Falls back to the serial path for small inputs.
+	void radixSortKeysParallel(FrameVector<SortItem>& items, FrameVector<SortItem>& scratch,
+							   ThreadPool& pool);
+}
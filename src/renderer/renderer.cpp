@@ -5,48 +5,95 @@
 #include <iostream>
 #include <cstring>
 #include <cassert>
+#include <chrono>
 #include "renderer/material_library.h"
+#include "core/thread_pool.h"
+#include "renderer/gl_state_tracker.h"
 
 namespace argon {
 	static constexpr std::size_t kMaxBatchedSprites = 20000;
 	static constexpr std::size_t kVertsPerSprite = 6;
 	static constexpr std::size_t kMaxBatchVerts = kMaxBatchedSprites * kVertsPerSprite;
+	// queues at least this long are sorted on the thread pool (if one is set)
+	static constexpr std::size_t kParallelSortThreshold = 65536;
 
-	static inline void mulMVP_xy(const float* m, float x, float y, float& outX, float& outY) {
-		//Mat4 * vec4(x, y, 0, 1)
-		//clip = M * [x y 0 1]^T
-		outX = m[0] * x + m[4] * y + m[12];
-		outY = m[1] * x + m[5] * y + m[13];
-	}
-	
-	std::uint64_t Renderer::makeSortKey(const Mesh& mesh, const Material2D& material) const {
+	// SortItem::index: command source in the top two bits, position below
+	static constexpr std::uint32_t kSourceShift = 30;
+	static constexpr std::uint32_t kPositionMask = (1u << kSourceShift) - 1;
+
+	static const UniformId kTexUniform = UniformId::of("uTex");
+	static const UniformId kModelUniform = UniformId::of("uModel");
+	static const UniformId kColorUniform = UniformId::of("uColor");
+	static const UniformId kUVRectUniform = UniformId::of("uUVRect");
+	enum CommandSource : std::uint32_t { kFromQueue = 0, kFromStream = 1, kFromStatic = 2 };
+
+	std::uint64_t Renderer::makeSortKey(const RenderPacket2D& pkt, const Material2D& material) const {
 		SortKey k{};
+		k.layer = pkt.layer;
+		k.translucent = material.translucent;
 
 		const Shader* shader = material.shader;
+		k.shaderId = shader ? shader->sortId() : 0;
 
-		k.shaderId = shader ? (std::uint32_t)shader->id() : 0;
-
-		const bool wantTex = (material.useTexture && material.texture);
-		k.textureId = wantTex ? (std::uint32_t)material.texture->id() : 0;
+		k.textureId = material.textured() ? material.texture->sortId() : 0;
 
-		k.vaoId = (std::uint32_t)mesh.vao();
+		k.meshId = pkt.mesh ? pkt.mesh->sortId() : 0;
+		k.depth = pkt.depth;
 
 		return k.pack();
 	}
 
+	std::uint64_t Renderer::sortKey(const RenderPacket2D& pkt, const MaterialLibrary& matlib) const {
+		static const Material2D kNoMaterial{};
+		const Material2D* mat = matlib.get(pkt.material);
+		return makeSortKey(pkt, mat ? *mat : kNoMaterial);
+	}
+
 	void Renderer::clear(float r, float g, float b, float a) const {
 		glClearColor(r, g, b, a);
 		glClear(GL_COLOR_BUFFER_BIT);
 	}
 
+	void Renderer::bindFrameMemory() {
+		if (!m_arena || m_arena->frame() == m_arenaFrame) return;
+		m_arenaFrame = m_arena->frame();
+		rebindFrameVector(m_queue, m_arena);
+		rebindFrameVector(m_queueKeys, m_arena);
+		rebindFrameVector(m_staticQueue, m_arena);
+		rebindFrameVector(m_sortItems, m_arena);
+		rebindFrameVector(m_sortScratch, m_arena);
+	}
+
+	void Renderer::beginFrame() {
+		if (m_inFrame) return;
+		m_inFrame = true;
+		bindFrameMemory();
+		m_spriteBatcher.beginFrame();
+	}
+
+	void Renderer::endFrame() {
+		if (!m_inFrame) return;
+		m_spriteBatcher.endFrame();
+		m_inFrame = false;
+	}
+
 	void Renderer::beginPass(const PassContext2D& ctx) {
 		assert(ctx.matlib && "PassContext2D.matlib is null");
+		m_implicitFrame = !m_inFrame;
+		if (m_implicitFrame) beginFrame();
+
 		m_stats.reset();
+		m_stats.ringFenceWaits = m_spriteBatcher.takeFenceWaits();
+		m_passUniformTraffic = Shader::uniformTraffic();
+		m_passStateStats = glState().stats();
 		m_PV = ctx.PV;
 		m_matlib = ctx.matlib;
 		m_inScene = true;
 
 		m_queue.clear();
+		m_queueKeys.clear();
+		m_stream = {};
+		m_staticQueue.clear();
 		m_batchVerts.clear();
 		m_hasVertexBatch = false;
 
@@ -58,15 +105,47 @@ namespace argon {
 		sink.vaoBinds = &m_stats.vaoBinds;
 		sink.batchFlushes = &m_stats.batchFlushes;
 		sink.batchedVerts = &m_stats.batchedVerts;
-
-		m_spriteBatcher.begin(m_PV, sink);
+		sink.instanceBytes = &m_stats.instanceBytes;
+
+		PassConstants2D constants{};
+		std::memcpy(constants.PV, m_PV.m, sizeof(constants.PV));
+		constants.viewport[0] = ctx.viewport.r;
+		constants.viewport[1] = ctx.viewport.g;
+		constants.viewport[2] = ctx.viewport.b;
+		constants.viewport[3] = ctx.viewport.a;
+		constants.time[0] = ctx.time;
+		constants.time[1] = ctx.dt;
+		m_passUniforms.upload(constants);
+
+		m_spriteBatcher.begin(sink);
+
+		MeshBatcher::StatsSink meshSink{};
+		meshSink.drawCalls = &m_stats.drawCalls;
+		meshSink.shaderBinds = &m_stats.shaderBinds;
+		meshSink.textureBinds = &m_stats.textureBinds;
+		meshSink.vaoBinds = &m_stats.vaoBinds;
+		meshSink.batchFlushes = &m_stats.batchFlushes;
+		meshSink.batchedVerts = &m_stats.batchedVerts;
+		meshSink.batchedMeshes = &m_stats.batchedMeshes;
+		meshSink.batchFallbacks = &m_stats.batchFallbacks;
+		m_meshBatcher.begin(meshSink);
 	}
 
 	void Renderer::endPass() {
 		if (!m_inScene) return;
 		flush();
+		const Shader::UniformTraffic& traffic = Shader::uniformTraffic();
+		m_stats.uniformUploads = (std::uint32_t)(traffic.uploads - m_passUniformTraffic.uploads);
+		m_stats.uniformSkips = (std::uint32_t)(traffic.skipped - m_passUniformTraffic.skipped);
+		const GLStateTracker::Stats& state = glState().stats();
+		m_stats.stateCalls = (std::uint32_t)(state.issued - m_passStateStats.issued);
+		m_stats.stateSkips = (std::uint32_t)(state.skipped - m_passStateStats.skipped);
 		m_inScene = false;
 		m_matlib = nullptr;
+		if (m_implicitFrame) {
+			endFrame();
+			m_implicitFrame = false;
+		}
 	}
 
 	void Renderer::submit(const RenderPacket2D& pkt) {
@@ -78,32 +157,120 @@ namespace argon {
 		const Material2D* mat = m_matlib ? m_matlib->get(pkt.material) : nullptr;
 		if (!mat || !mat->shader) return;
 
-		RenderCommand cmd;
-		cmd.mesh = pkt.mesh;
-		cmd.model = pkt.model;
-		cmd.material = pkt.material;
-		cmd.layer = (std::uint32_t)pkt.layer;
-		cmd.tint = pkt.tint;
-		cmd.uvRect = pkt.uvRect;
-
-		cmd.key = makeSortKey(*cmd.mesh, *mat);
-		m_queue.push_back(cmd);
+		m_queue.push_back(pkt);
+		m_queueKeys.push_back(makeSortKey(pkt, *mat));
 		m_stats.queueCommands++;
 	}
 
+	void Renderer::submit(const RenderPacket2D* pkts, std::size_t count) {
+		if (!m_inScene) return;
+		// m_queue keeps its capacity across passes, no reserve needed
+		for (std::size_t i = 0; i < count; ++i) {
+			submit(pkts[i]);
+		}
+	}
+
+	void Renderer::submit(const PacketView2D& view) {
+		if (!m_inScene || view.empty()) return;
+		if (!m_stream.empty()) {
+			submit(view.packets, view.count);
+			return;
+		}
+		assert(view.count <= kPositionMask && "packet stream too long");
+		m_stream = view;
+		m_stats.queueCommands += (std::uint32_t)view.count;
+	}
+
+
+	bool Renderer::canBakeStatic(const RenderPacket2D& pkt) const {
+		if (!m_matlib || !pkt.mesh) return false;
+		const Material2D* mat = m_matlib->get(pkt.material);
+		return mat && mat->shader && m_spriteBatcher.canInstance(pkt.mesh, *mat);
+	}
+
+	void Renderer::bakeStatic(const RenderPacket2D* pkts, std::size_t count) {
+		if (!m_matlib) return;
+
+		std::vector<RenderPacket2D> packets;
+		std::vector<const Material2D*> materials;
+		std::vector<std::uint64_t> keys;
+		packets.reserve(count);
+		materials.reserve(count);
+		keys.reserve(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			if (!pkts[i].visible || !canBakeStatic(pkts[i])) continue;
+			const Material2D* mat = m_matlib->get(pkts[i].material);
+			packets.push_back(pkts[i]);
+			materials.push_back(mat);
+			keys.push_back(makeSortKey(pkts[i], *mat));
+		}
+
+		m_static.bake(packets.data(), materials.data(), keys.data(), SortKey::kInstanceBatchMask,
+					  packets.size(), m_spriteBatcher);
+	}
+
+	void Renderer::submitStatic(const CullRect& view) {
+		if (!m_inScene) return;
+		m_static.forEachVisible(view, [&](const StaticSpriteRange& range) {
+			m_staticQueue.push_back(&range);
+			m_stats.queueCommands++;
+		});
+	}
+
+	void Renderer::drawStatic(const StaticSpriteRange& range, GLStateTracker& st) {
+		m_spriteBatcher.drawBaked(range.layout, range.material, range.vao, range.buffer,
+								  range.textures, range.textureCount, range.first, range.count, st);
+		m_stats.staticDraws++;
+		m_stats.staticSprites += range.count;
+	}
+
+	void Renderer::sortQueue() {
+		using clock = std::chrono::steady_clock;
+		const auto t0 = clock::now();
+
+		// sort 16-byte (key, index) pairs, the packets themselves never move
+		const std::size_t queued = m_queueKeys.size();
+		const std::size_t streamed = m_stream.count;
+		const std::size_t baked = m_staticQueue.size();
+		const std::size_t n = queued + streamed + baked;
+		m_sortItems.resize(n);
+
+		SortItem* out = m_sortItems.data();
+		for (std::size_t i = 0; i < queued; ++i, ++out) {
+			out->key = m_queueKeys[i];
+			out->index = (kFromQueue << kSourceShift) | (std::uint32_t)i;
+		}
+		for (std::size_t i = 0; i < streamed; ++i, ++out) {
+			out->key = m_stream.keys[i];
+			out->index = (kFromStream << kSourceShift) | (std::uint32_t)i;
+		}
+		for (std::size_t i = 0; i < baked; ++i, ++out) {
+			out->key = m_staticQueue[i]->key;
+			out->index = (kFromStatic << kSourceShift) | (std::uint32_t)i;
+		}
+
+		const bool parallel = m_jobs && n >= kParallelSortThreshold;
+		if (parallel) radixSortKeysParallel(m_sortItems, m_sortScratch, *m_jobs);
+		else radixSortKeys(m_sortItems, m_sortScratch);
+
+		m_stats.sortParallel = parallel;
+		m_stats.sortMs += std::chrono::duration<float, std::milli>(clock::now() - t0).count();
+	}
 
 	void Renderer::flush() {
-		if (m_queue.empty()) return;
-		if (!m_matlib) { m_queue.clear(); return; }
+		const auto clearQueue = [this] {
+			m_queue.clear();
+			m_queueKeys.clear();
+			m_stream = {};
+			m_staticQueue.clear();
+		};
+		if (m_queueKeys.empty() && m_stream.empty() && m_staticQueue.empty()) return;
+		if (!m_matlib) { clearQueue(); return; }
 
-		std::sort(m_queue.begin(), m_queue.end(),
-			[](const RenderCommand& a, const RenderCommand& b) {
-				if (a.layer != b.layer) return a.layer < b.layer;
-				return a.key < b.key;
-			}
-		);
+		sortQueue();
 
-		RenderStateCache st{};
+		// persistent: what the previous pass left bound is not bound again
+		GLStateTracker& st = glState();
 
 		// ---- local cache: avoid calling matlib->get for every cmd ----
 		MaterialHandle lastH{};                 // depends on your handle type; default {} ok
@@ -118,13 +285,39 @@ namespace argon {
 			return cachedMat;
 			};
 
+		// depth only orders draws inside a state group and instanced sprites
+		// spread textures over units, neither splits an instanced batch
 		std::uint64_t currentKey = 0;
 		bool hasKey = false;
-
-		// note: m_hasBatchMaterial indicates we have an active instancing batch (with m_batchMaterial set)
-
-		for (const auto& cmd : m_queue) {
-			if (!cmd.mesh) continue;
+		// open mesh batch; at most one of the two batchers holds draws at a time
+		std::uint64_t currentMeshKey = 0;
+		bool hasMeshKey = false;
+
+		auto flushMeshes = [&] {
+			m_meshBatcher.flush(st);
+			hasMeshKey = false;
+		};
+		// translucent materials blend; the key's translucent bit already split
+		// every batch, so this only runs once the pending draws went out
+		auto applyBlend = [&](const Material2D& m) {
+			st.setBlend(m.translucent);
+			if (m.translucent) st.setBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		};
+
+		for (const SortItem& item : m_sortItems) {
+			const std::uint32_t source = item.index >> kSourceShift;
+			const std::uint32_t pos = item.index & kPositionMask;
+			if (source == kFromStatic) {
+				// one baked draw; it never joins the streamed batch
+				m_spriteBatcher.flush(st);
+				flushMeshes();
+				applyBlend(m_staticQueue[pos]->material);
+				drawStatic(*m_staticQueue[pos], st);
+				hasKey = false;
+				continue;
+			}
+			const RenderPacket2D& cmd = source == kFromStream ? m_stream.packets[pos] : m_queue[pos];
+			if (!cmd.mesh || !cmd.visible) continue;
 
 			const Material2D* material = getMatCached(cmd.material);
 			if (!material || !material->shader) continue;
@@ -132,35 +325,52 @@ namespace argon {
 			const bool canInst = m_spriteBatcher.canInstance(cmd.mesh, *material);
 
 			if (!canInst) {
-				// flush any pending instanced sprites before non-batch draw
+				// flush any pending instanced sprites before the mesh paths
 				m_spriteBatcher.flush(st);
-				drawNonBatch(cmd, st);
 				hasKey = false;
+
+				if (m_meshBatcher.canBatch(cmd.mesh, *material)) {
+					const std::uint64_t meshKey = item.key & SortKey::kMeshBatchMask;
+					if (hasMeshKey && meshKey != currentMeshKey) m_meshBatcher.flush(st);
+					currentMeshKey = meshKey;
+					hasMeshKey = true;
+					applyBlend(*material);
+					const Affine2D model = cmd.gpuTransform ? cmd.trs.affine() : cmd.model;
+					if (m_meshBatcher.submit(*cmd.mesh, *material, model, cmd.tint, cmd.uvRect, st)) continue;
+				}
+
+				flushMeshes();
+				applyBlend(*material);
+				drawNonBatch(cmd, st);
 				continue;
 			}
+			flushMeshes();
 
 			// ---- instancing path ----
-			// If starting a batch, set batch material+key
+			// If starting a batch, set batch key.
+			// The batcher tracks the actual textures, so aliased texture ids stay correct.
+			const std::uint64_t batchKey = item.key & SortKey::kInstanceBatchMask;
 			if (!hasKey) {
-				currentKey = cmd.key;
+				currentKey = batchKey;
 				hasKey = true;
 			}
-			else if (cmd.key != currentKey) {
+			else if (batchKey != currentKey) {
 				m_spriteBatcher.flush(st);
-				currentKey = cmd.key;
+				currentKey = batchKey;
 			}
+			applyBlend(*material);
 
-			m_spriteBatcher.submit(cmd.key, *material, cmd.model, cmd.tint, cmd.uvRect);
+			if (cmd.gpuTransform) m_spriteBatcher.submit(*material, cmd.trs, cmd.tint, cmd.uvRect, st);
+			else m_spriteBatcher.submit(*material, cmd.model, cmd.tint, cmd.uvRect, st);
 		}
-		// flush remaining instanced sprites
+		// flush remaining batches
 		m_spriteBatcher.flush(st);
-		glBindVertexArray(0);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		m_queue.clear();
+		m_meshBatcher.flush(st);
+		clearQueue();
 
 	}
 
-	void Renderer::drawNonBatch(const RenderCommand& cmd, RenderStateCache& st) {
+	void Renderer::drawNonBatch(const RenderPacket2D& cmd, GLStateTracker& st) {
 		if (!m_matlib) return;
 
 		const Material2D* material = m_matlib->get(cmd.material);
@@ -169,46 +379,27 @@ namespace argon {
 		const Shader& shader = *material->shader;
 		const Mesh& mesh = *cmd.mesh;
 		
-		const std::uint32_t shaderId = (std::uint32_t)shader.id();
-		if (shaderId != st.shaderId) {
-			shader.use();
+		if (st.useProgram(shader.id())) {
 			// TODO here assume the texture is always in 0
-			shader.setInt("uTex", 0);
-			st.shaderId = shaderId;
+			shader.setInt(kTexUniform, 0);
 			m_stats.shaderBinds++;
 		}
 
-		//MVP
-		Mat4 MVP = mul(m_PV, cmd.model);
-		shader.setMat4("uMVP", MVP.m);
-		shader.setVec4("uColor", material->color.r * cmd.tint.r,
+		// PV comes from the pass block, only the model is uploaded
+		const Affine2D model = cmd.gpuTransform ? cmd.trs.affine() : cmd.model;
+		shader.setMat4(kModelUniform, model.toMat4().m);
+		shader.setVec4(kColorUniform, material->color.r * cmd.tint.r,
 +							 material->color.g * cmd.tint.g,
 +							 material->color.b * cmd.tint.b,
 +							 material->color.a * cmd.tint.a);
-		shader.setVec4("uUVRect", cmd.uvRect.r, cmd.uvRect.g, cmd.uvRect.b, cmd.uvRect.a);
-
-		const bool wantTex = (material->useTexture && material->texture);
-		shader.setInt("uUseTex", wantTex ? 1 : 0);
-		const std::uint32_t texId = wantTex ? (std::uint32_t)material->texture->id() : 0;
-		if (wantTex) {
-			if (texId != st.textureId) {
-				material->texture->bind(0);
-				st.textureId = texId;
-				m_stats.textureBinds++;
-			}
-		} else {
-			if (st.textureId != 0) {
-				glActiveTexture(GL_TEXTURE0);
-				glBindTexture(GL_TEXTURE_2D, 0);
-				st.textureId = 0;
-				m_stats.textureBinds++;
-			}
+		shader.setVec4(kUVRectUniform, cmd.uvRect.r, cmd.uvRect.g, cmd.uvRect.b, cmd.uvRect.a);
+
+		// untextured variants declare no sampler, whatever is bound stays
+		if (material->textured() && st.bindTexture(0, GL_TEXTURE_2D, material->texture->id())) {
+			m_stats.textureBinds++;
 		}
 
-		const std::uint32_t vaoId = (std::uint32_t)mesh.vao();
-		if (vaoId != st.vaoId) {
-			mesh.bind();
-			st.vaoId = vaoId;
+		if (st.bindVertexArray(mesh.vao())) {
 			m_stats.vaoBinds++;
 		}
 
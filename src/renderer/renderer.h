@@ -1,17 +1,24 @@
 #pragma once
 #include <vector>
 #include <cstdint>
+#include "core/frame_arena.h"
 #include "math/mat4.h"
 #include "gfx/camera2d.h"
 #include "renderer/mesh.h"
 #include "renderer/material2d.h"
+#include "renderer/mesh_batcher.h"
+#include "renderer/packet_stream2d.h"
+#include "renderer/pass_constants.h"
 #include "renderer/render_packet2d.h"
-#include "renderer/render_state_cache.h"
+#include "renderer/render_sort.h"
+#include "renderer/gl_state_tracker.h"
 #include "renderer/sprite_batcher.h"
+#include "renderer/static_sprite_cache.h"
 #include "renderer/texture_atlas.h"
 
 namespace argon {
 	class MaterialLibrary;
+	class ThreadPool;
 
 	class Renderer {
 	public:
@@ -25,13 +32,92 @@ namespace argon {
 			std::uint32_t batchFlushes = 0;
 			std::uint32_t batchedVerts = 0;
 			std::uint32_t batchedSprites = 0;
+			float sortMs = 0.0f;
+			bool sortParallel = false;
+			std::uint32_t instanceBytes = 0;
+			std::uint32_t ringFenceWaits = 0; // frame starts that blocked on the GPU
+			std::uint32_t staticDraws = 0;    // baked ranges drawn
+			std::uint32_t staticSprites = 0;  // sprites in those ranges
+			std::uint32_t batchedMeshes = 0;  // non-sprite meshes drawn through multi-draw batches
+			std::uint32_t batchFallbacks = 0; // batchable meshes drawn alone, mesh geometry buffer full
+			std::uint32_t uniformUploads = 0; // glUniform* calls issued by engine shaders
+			std::uint32_t uniformSkips = 0;   // setter calls skipped, the value was already set
+			std::uint32_t stateCalls = 0;     // binds and state changes that reached GL
+			std::uint32_t stateSkips = 0;     // ones GLStateTracker dropped as redundant
 
 			void reset() { *this = Stats{}; }
 		};
 
+		// 64-bit sort key, most significant first:
+		//   [63..48] layer (signed, biased)   [47] translucent
+		//   [46..36] shader id                [35..24] mesh id
+		//   [23..10] texture id               [9..0]   depth
+		// Ids are the dense RenderIds handed out per resource, never GL names,
+		// so fields cannot alias while the live count fits the field width.
+		struct SortKey {
+			static constexpr int kDepthBits = 10;
+			static constexpr int kTextureBits = 14;
+			static constexpr int kMeshBits = 12;
+			static constexpr int kShaderBits = 11;
+			static constexpr int kTranslucentBits = 1;
+			static constexpr int kLayerBits = 16;
+
+			static constexpr int kDepthShift = 0;
+			static constexpr int kTextureShift = kDepthShift + kDepthBits;
+			static constexpr int kMeshShift = kTextureShift + kTextureBits;
+			static constexpr int kShaderShift = kMeshShift + kMeshBits;
+			static constexpr int kTranslucentShift = kShaderShift + kShaderBits;
+			static constexpr int kLayerShift = kTranslucentShift + kTranslucentBits;
+			static_assert(kLayerShift + kLayerBits == 64, "sort key layout must fill 64 bits");
+
+			static constexpr std::uint32_t kDepthMax = (1u << kDepthBits) - 1;
+			static constexpr std::uint32_t kTextureMax = (1u << kTextureBits) - 1;
+			static constexpr std::uint32_t kMeshMax = (1u << kMeshBits) - 1;
+			static constexpr std::uint32_t kShaderMax = (1u << kShaderBits) - 1;
+
+			// everything but depth: commands with equal state bits can share a batch
+			static constexpr std::uint64_t kStateMask = ~(std::uint64_t(kDepthMax) << kDepthShift);
+			// instanced sprites bind up to GLStateTracker::kTextureUnits textures per
+			// batch, so texture does not split them either; it still clusters equal
+			// textures so consecutive batches reuse the same unit bindings
+			static constexpr std::uint64_t kInstanceBatchMask = kStateMask & ~(std::uint64_t(kTextureMax) << kTextureShift);
+			// mesh batches fetch their vertices from shared geometry: the mesh does not split them
+			static constexpr std::uint64_t kMeshBatchMask = kStateMask & ~(std::uint64_t(kMeshMax) << kMeshShift);
+
+			std::int32_t layer = 0;
+			bool translucent = false;
+			std::uint32_t shaderId = 0;
+			std::uint32_t meshId = 0;
+			std::uint32_t textureId = 0;
+			std::uint32_t depth = 0;
+
+			static std::uint64_t field(std::uint32_t v, std::uint32_t max, int shift) {
+				return std::uint64_t(v < max ? v : max) << shift;
+			}
+
+			std::uint64_t pack() const {
+				// clamp to 16 bits and bias the signed layer so negative layers sort first
+				const std::int32_t clamped = layer < -32768 ? -32768 : (layer > 32767 ? 32767 : layer);
+				const std::uint64_t biasedLayer = std::uint64_t(clamped + 32768);
+				std::uint64_t key = 0;
+				key |= (biasedLayer << kLayerShift);
+				key |= (std::uint64_t(translucent ? 1 : 0) << kTranslucentShift);
+				key |= field(shaderId, kShaderMax, kShaderShift);
+				key |= field(meshId, kMeshMax, kMeshShift);
+				key |= field(textureId, kTextureMax, kTextureShift);
+				key |= field(depth, kDepthMax, kDepthShift);
+				return key;
+			}
+		};
+
+		// PV, viewport and time go to the PassConstants uniform block once per
+		// pass; shaders read them from there instead of per-draw uniforms
 		struct PassContext2D {
 			Mat4 PV = Mat4::identity();
 			const MaterialLibrary* matlib = nullptr;
+			Vec4 viewport{ 0.0f, 0.0f, 0.0f, 0.0f }; // x, y, width, height in pixels
+			float time = 0.0f;
+			float dt = 0.0f;
 		};
 
 		const Stats& stats() const { return m_stats; }
@@ -39,44 +125,68 @@ namespace argon {
 
 		void clear(float r, float g, float b, float a) const;
 
+		// Brackets all passes of one frame; streamed GPU buffers rotate here.
+		// A pass outside beginFrame/endFrame is treated as its own frame.
+		void beginFrame();
+		void endFrame();
+
 		void beginPass(const PassContext2D& ctx);
 		void endPass();
 		void submit(const RenderPacket2D& pkt);
+		void submit(const RenderPacket2D* pkts, std::size_t count);
+		// Queues a recorded stream by reference: only (key, index) pairs are
+		// built and sorted, packets are read in place at endPass. The view must
+		// stay valid until then and its keys must come from sortKey() with this
+		// pass's material library. A second stream in the same pass is copied.
+		void submit(const PacketView2D& view);
+
+		// key submit() would give pkt; packets without a usable material still
+		// get one and are skipped when drawn
+		std::uint64_t sortKey(const RenderPacket2D& pkt, const MaterialLibrary& matlib) const;
 		
 		void setAtlas(const TextureAtlas* atlas) { m_atlas = atlas; }
 		void setSpriteQuad(const Mesh* quad) { m_spriteBatcher.setSpriteQuad(quad); }
 		void setInstancedSpriteShader(const Shader* s) { m_spriteBatcher.setInstancedSpriteShader(s); }
+		void setCompactSpriteShader(const Shader* s) { m_spriteBatcher.setCompactSpriteShader(s); }
+		void setTrsSpriteShader(const Shader* s) { m_spriteBatcher.setTrsSpriteShader(s); }
+		// packets of this mesh may carry RenderPacket2D::trs instead of a model
+		bool expandsTransformOnGpu(const Mesh* mesh) const { return m_spriteBatcher.expandsTransformOnGpu(mesh); }
+		// other meshes whose material is built from materialShaders are batched
+		// into multi-draws with batchShaders (see MeshBatcher for its inputs)
+		void setMeshBatchShaders(const ShaderPermutations* materialShaders, ShaderPermutations* batchShaders) {
+			m_meshBatcher.setShaders(materialShaders, batchShaders);
+		}
+		void setSpriteInstanceLayout(SpriteInstanceLayout layout) { m_spriteBatcher.setInstanceLayout(layout); }
+		SpriteInstanceLayout spriteInstanceLayout() const { return m_spriteBatcher.instanceLayout(); }
+		// Static sprites are baked once into chunked GPU buffers and drawn one
+		// range per visible chunk, sorted with the queue like any other command.
+		// The calls below need an open pass (they resolve materials).
+		bool canBakeStatic(const RenderPacket2D& pkt) const;
+		void bakeStatic(const RenderPacket2D* pkts, std::size_t count);
+		void submitStatic(const CullRect& view);
+		void clearStatic() { m_static.clear(); }
+		void setStaticChunkSize(float size) { m_static.setChunkSize(size); }
+		const StaticSpriteCache::Stats& staticStats() const { return m_static.stats(); }
+
+		// optional: queues of kParallelSortThreshold+ commands are sorted on this pool
+		void setThreadPool(ThreadPool* pool) { m_jobs = pool; }
+
+		// optional: the queue and sort buffers are taken from this arena, rebound
+		// at beginFrame; without one they are ordinary heap vectors
+		void setFrameArena(FrameArena* arena) { m_arena = arena; }
 
 	private:
-		struct RenderCommand {
-			const Mesh* mesh = nullptr;
-			Mat4 model = Mat4::identity();
-			MaterialHandle material = {};
-			std::uint32_t layer = 0;
-			std::uint64_t key = 0;
-			Vec4 tint{ 1.0f,1.0f,1.0f,1.0f };
-			Vec4 uvRect{ 0.0f,0.0f,1.0f,1.0f }; // (u0,v0,u1,v1)
-		};
-
-		struct SortKey {
-			std::uint32_t shaderId = 0;
-			std::uint32_t textureId = 0;
-			std::uint32_t vaoId = 0;
-			std::uint64_t pack() const {
-				std::uint64_t key = 0;
-				key |= (std::uint64_t(shaderId) << 32);
-				key |= (std::uint64_t(textureId) << 16);
-				key |= (std::uint64_t(vaoId));
-				return key;
-			}
-		};
-
 		struct BatchVertex { float x, y, u, v; };
 
-		std::uint64_t makeSortKey(const Mesh& mesh, const Material2D& material) const;
+		// moves the per-frame buffers onto the arena's current frame
+		void bindFrameMemory();
+
+		std::uint64_t makeSortKey(const RenderPacket2D& pkt, const Material2D& material) const;
 
+		void sortQueue();
 		void flush();
-		void drawNonBatch(const RenderCommand& cmd, RenderStateCache& st);
+		void drawNonBatch(const RenderPacket2D& pkt, GLStateTracker& st);
+		void drawStatic(const StaticSpriteRange& range, GLStateTracker& st);
 
 	private:
 		Stats m_stats{};
@@ -84,10 +194,19 @@ namespace argon {
 
 		// legacy vertex batch (not used currently)
 		bool m_inScene = false;
+		bool m_inFrame = false;
+		bool m_implicitFrame = false;
 		bool m_batchInited = false;
 		bool m_hasVertexBatch = false;
 
-		std::vector<RenderCommand> m_queue;
+		// A pass draws from three sources, merged by one sort: packets copied by
+		// submit(pkt), one stream submitted by reference, and baked ranges.
+		FrameVector<RenderPacket2D> m_queue;
+		FrameVector<std::uint64_t> m_queueKeys;
+		PacketView2D m_stream;
+		FrameVector<const StaticSpriteRange*> m_staticQueue;
+		FrameVector<SortItem> m_sortItems;
+		FrameVector<SortItem> m_sortScratch;
 		std::vector<BatchVertex> m_batchVerts;
 
 		std::size_t m_batchVboCapacityVerts = 0; // how many BatchVertex can be contained in current VBO
@@ -95,8 +214,16 @@ namespace argon {
 		unsigned int m_batchVBO = 0;
 		Material2D m_vertexBatchMaterial{};
 		SpriteBatcher m_spriteBatcher;
+		MeshBatcher m_meshBatcher;
+		PassUniformBuffer m_passUniforms;
+		StaticSpriteCache m_static;
 
 		const TextureAtlas* m_atlas = nullptr;
 		const MaterialLibrary* m_matlib = nullptr;
+		ThreadPool* m_jobs = nullptr;
+		FrameArena* m_arena = nullptr;
+		std::uint64_t m_arenaFrame = ~0ull; // arena frame the buffers were bound in
+		Shader::UniformTraffic m_passUniformTraffic; // Shader::uniformTraffic() at beginPass
+		GLStateTracker::Stats m_passStateStats;      // glState().stats() at beginPass
 	};
 }
\ No newline at end of file
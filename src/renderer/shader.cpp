@@ -1,4 +1,10 @@
 #include "shader.h"
+#include "renderer/pass_constants.h"
+#include "renderer/gl_state_tracker.h"
+#include "renderer/program_cache.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -30,6 +36,7 @@ namespace argon {
 		GLuint prog = glCreateProgram();
 		glAttachShader(prog, vsId);
 		glAttachShader(prog, fsId);
+		hintProgramRetrievable(prog);
 		glLinkProgram(prog);
 
 		GLint ok = 0;
@@ -46,70 +53,197 @@ namespace argon {
 		return prog;
 	}
 
-	Shader::Shader(const char* vsSrc, const char* fsSrc) {
-		GLuint vsId = compile(GL_VERTEX_SHADER, vsSrc);
-		if (!vsId) return;
+	// block bindings are not part of a program binary, so this runs on both paths
+	void Shader::bindUniformBlocks(GLuint prog) {
+		// per-pass constants come from the buffer bound at the fixed point
+		const GLuint block = glGetUniformBlockIndex(prog, "PassConstants");
+		if (block != GL_INVALID_INDEX) glUniformBlockBinding(prog, block, kPassConstantsBinding);
+	}
 
-		GLuint fsId = compile(GL_FRAGMENT_SHADER, fsSrc);
-		if (!fsId) {
+	Shader::Shader(const char* vsSrc, const char* fsSrc) {
+		const bool cached = programCacheEnabled();
+		const std::uint64_t key = cached ? programCacheKey(vsSrc, fsSrc) : 0;
+		if (cached) m_program = loadCachedProgram(key);
+
+		if (!m_program) {
+			const auto t0 = std::chrono::high_resolution_clock::now();
+			GLuint vsId = compile(GL_VERTEX_SHADER, vsSrc);
+			if (!vsId) return;
+
+			GLuint fsId = compile(GL_FRAGMENT_SHADER, fsSrc);
+			if (!fsId) {
+				glDeleteShader(vsId);
+				return;
+			}
+			m_program = link(vsId, fsId);
 			glDeleteShader(vsId);
-			return;
+			glDeleteShader(fsId);
+			if (!m_program) return;
+
+			const double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - t0).count();
+			storeCachedProgram(key, m_program, ms);
 		}
-		m_program = link(vsId, fsId);
-		m_locCache.clear();
-		m_uniformLookups = 0;
-		m_uniformGLQueries = 0;
-		glDeleteShader(vsId);
-		glDeleteShader(fsId);
+
+		bindUniformBlocks(m_program);
+		reflectUniforms();
 	}
 
 	Shader::~Shader() {
 		if (m_program) {
+			glState().forgetProgram(m_program);
 			glDeleteProgram(m_program);
 			m_program = 0;
 		}
+		RenderIds::release(RenderIdKind::Shader, m_sortId);
 	}
 
 	void Shader::use() const {
-		glUseProgram(m_program);
+		glState().useProgram(m_program);
+	}
+
+	// 32-bit components of one element of a uniform of this type
+	static std::uint32_t componentsOf(GLenum type) {
+		switch (type) {
+		case GL_FLOAT_VEC2: case GL_INT_VEC2: case GL_UNSIGNED_INT_VEC2: case GL_BOOL_VEC2: return 2;
+		case GL_FLOAT_VEC3: case GL_INT_VEC3: case GL_UNSIGNED_INT_VEC3: case GL_BOOL_VEC3: return 3;
+		case GL_FLOAT_VEC4: case GL_INT_VEC4: case GL_UNSIGNED_INT_VEC4: case GL_BOOL_VEC4: return 4;
+		case GL_FLOAT_MAT2: return 4;
+		case GL_FLOAT_MAT2x3: case GL_FLOAT_MAT3x2: return 6;
+		case GL_FLOAT_MAT2x4: case GL_FLOAT_MAT4x2: return 8;
+		case GL_FLOAT_MAT3: return 9;
+		case GL_FLOAT_MAT3x4: case GL_FLOAT_MAT4x3: return 12;
+		case GL_FLOAT_MAT4: return 16;
+		default: return 1; // scalars and samplers
+		}
+	}
+
+	static Shader::UniformTraffic s_uniformTraffic;
+
+	const Shader::UniformTraffic& Shader::uniformTraffic() {
+		return s_uniformTraffic;
+	}
+
+	void Shader::reflectUniforms() {
+		m_slots.clear();
+		m_uniforms.clear();
+		m_shadow.clear();
+		m_shadowSet.clear();
+		if (!m_program) return;
+
+		GLint count = 0;
+		GLint maxLen = 0;
+		glGetProgramiv(m_program, GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(m_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLen);
+		std::string name((std::size_t)(maxLen > 0 ? maxLen : 1), '\0');
+
+		std::uint32_t shadowWords = 0;
+		for (GLint i = 0; i < count; ++i) {
+			GLsizei len = 0;
+			GLint size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(m_program, (GLuint)i, (GLsizei)name.size(), &len, &size, &type, &name[0]);
+			std::string base(name.data(), (std::size_t)len);
+			// arrays report "name[0]", setters address them by the base name
+			if (base.size() > 3 && base.compare(base.size() - 3, 3, "[0]") == 0) base.resize(base.size() - 3);
+
+			m_uniformGLQueries++;
+			const GLint loc = glGetUniformLocation(m_program, base.c_str());
+			if (loc < 0) continue; // lives in a uniform block
+
+			const UniformId id = UniformId::of(base.c_str());
+			if (id.index >= m_slots.size()) m_slots.resize((std::size_t)id.index + 1, -1);
+			m_slots[id.index] = (std::int32_t)m_uniforms.size();
+
+			UniformInfo u{ id, loc, type, size };
+			u.shadowOffset = shadowWords;
+			u.shadowWords = componentsOf(type) * (std::uint32_t)(size > 0 ? size : 1);
+			shadowWords += u.shadowWords;
+			m_uniforms.push_back(u);
+		}
+		// a freshly linked (or loaded) program holds defaults we never wrote
+		m_shadow.assign(shadowWords, 0);
+		m_shadowSet.assign(m_uniforms.size(), 0);
 	}
 
-	GLint Shader::uniformLoc(const char* name) const {
+	void Shader::invalidateUniformShadows() const {
+		std::fill(m_shadowSet.begin(), m_shadowSet.end(), 0u);
+	}
+
+	GLint Shader::changed(UniformId id, const void* data, std::uint32_t words) const {
+		const UniformInfo* u = info(id);
+		if (!u) return -1;
+
+		// more than the uniform holds: let GL report it, nothing to compare against
+		if (words > u->shadowWords) {
+			s_uniformTraffic.uploads++;
+			return u->location;
+		}
+
+		const std::size_t slot = (std::size_t)(u - m_uniforms.data());
+		std::uint32_t* shadow = m_shadow.data() + u->shadowOffset;
+		const std::size_t bytes = words * sizeof(std::uint32_t);
+		if (m_shadowSet[slot] == words && std::memcmp(shadow, data, bytes) == 0) {
+			s_uniformTraffic.skipped++;
+			return -1;
+		}
+		std::memcpy(shadow, data, bytes);
+		m_shadowSet[slot] = words;
+		s_uniformTraffic.uploads++;
+		return u->location;
+	}
 
+	// names not active in this program are interned too and resolve to -1
+	UniformId Shader::nameId(const char* name) const {
 		m_uniformLookups++;
-		if (!m_program || !name) return -1;
-		// check cache first
-		auto it = m_locCache.find(name);
-		if (it != m_locCache.end())
-			return it->second;
-		// if not in Cache, check OpenGL
-		m_uniformGLQueries++;
-		GLint loc = glGetUniformLocation(m_program, name);
+		if (!m_program || !name) return {};
+		return UniformId::of(name);
+	}
+
+	void Shader::setFloat(UniformId id, float v) const {
+		GLint loc = changed(id, &v, 1);
+		if (loc >= 0) glUniform1f(loc, v);
+	}
+
+	void Shader::setMat4(UniformId id, const float* m4) const {
+		GLint loc = changed(id, m4, 16);
+		if (loc >= 0) glUniformMatrix4fv(loc, 1, GL_FALSE, m4);
+	}
 
-		// put the loc into cache (even cache when loc=-1)
-		// to avoid checking uniform don't exist
-		m_locCache.try_emplace(name, loc);
-		return loc;
+	void Shader::setVec4(UniformId id, const float r, const float g, const float b, const float a) const {
+		const float v[4] = { r, g, b, a };
+		GLint loc = changed(id, v, 4);
+		if (loc >= 0) glUniform4f(loc, r, g, b, a);
+	}
+
+	void Shader::setInt(UniformId id, int v) const {
+		GLint loc = changed(id, &v, 1);
+		if (loc >= 0) glUniform1i(loc, v);
+	}
+
+	void Shader::setIntArray(UniformId id, const int* v, int count) const {
+		if (count <= 0) return;
+		GLint loc = changed(id, v, (std::uint32_t)count);
+		if (loc >= 0) glUniform1iv(loc, count, v);
 	}
 
 	void Shader::setFloat(const char* name, float v) const {
-		GLint loc = uniformLoc(name);
-		if (loc >= 0) glUniform1f(loc, v);
+		setFloat(nameId(name), v);
 	}
 
 	void Shader::setMat4(const char* name, const float* m4) const {
-		GLint loc = uniformLoc(name);
-		if (loc >= 0)glUniformMatrix4fv(loc, 1, GL_FALSE, m4);
+		setMat4(nameId(name), m4);
 	}
 
 	void Shader::setVec4(const char* name, const float r, const float g, const float b, const float a) const {
-		GLint loc = uniformLoc(name);
-		if (loc >= 0)glUniform4f(loc, r, g, b, a);
+		setVec4(nameId(name), r, g, b, a);
 	}
 
 	void Shader::setInt(const char* name, int v) const {
-		GLint loc = uniformLoc(name);
-		if (loc >= 0) glUniform1i(loc, v);
+		setInt(nameId(name), v);
+	}
+
+	void Shader::setIntArray(const char* name, const int* v, int count) const {
+		setIntArray(nameId(name), v, count);
 	}
 
-}
\ No newline at end of file
+}
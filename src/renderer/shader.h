@@ -1,13 +1,32 @@
 #pragma once
-#include <unordered_map>
+#include <vector>
 #include <glad/glad.h>
 #include <cstdint>
-#include <string>
+#include "renderer/render_ids.h"
+#include "renderer/uniform_id.h"
 
 namespace argon {
 
 	class Shader {
 	public:
+		// one active uniform of the linked program (block members excluded)
+		struct UniformInfo {
+			UniformId id;
+			GLint location = -1;
+			GLenum type = 0;
+			GLint size = 0;   // array length, 1 otherwise
+			std::uint32_t shadowOffset = 0; // first word of the shadow copy
+			std::uint32_t shadowWords = 0;  // 32-bit components of the whole uniform
+		};
+
+		// glUniform* calls issued vs skipped because the value was already set,
+		// summed over all programs since startup
+		struct UniformTraffic {
+			std::uint64_t uploads = 0;
+			std::uint64_t skipped = 0;
+		};
+
+		// loads from the program binary cache when enabled, compiles otherwise
 		Shader(const char* vsSrc, const char* fsSrc);
 		~Shader();
 
@@ -16,23 +35,62 @@ namespace argon {
 
 		void use() const;
 		GLuint id() const { return m_program; }
+		std::uint32_t sortId() const { return m_sortId; }
+
+		// -1 when the program has no such active uniform
+		GLint location(UniformId id) const {
+			const UniformInfo* u = info(id);
+			return u ? u->location : -1;
+		}
+		bool has(UniformId id) const { return id.index < m_slots.size() && m_slots[id.index] >= 0; }
+		const std::vector<UniformInfo>& uniforms() const { return m_uniforms; }
+
+		// Setters keep a copy of the last value per uniform and skip the GL call
+		// when it has not changed. Program uniforms persist across binds, so the
+		// copies stay valid until something sets them behind the Shader's back.
+		void invalidateUniformShadows() const;
+		static const UniformTraffic& uniformTraffic();
+
+		void setFloat(UniformId id, float v) const;
+		void setMat4(UniformId id, const float* m4) const;
+		void setVec4(UniformId id, const float r, const float g, const float b, const float a) const;
+		void setInt(UniformId id, int v) const;
+		void setIntArray(UniformId id, const int* v, int count) const;
 
+		// by name: interns the name first (a hash per call), keep off hot paths
 		void setFloat(const char* name, float v) const;
 		void setMat4(const char* name, const float* m4) const;
 		void setVec4(const char* name, const float r, const float g, const float b, const float a) const;
 		void setInt(const char* name, int v)  const;
+		void setIntArray(const char* name, const int* v, int count) const;
 
+		// string-keyed resolutions; stays flat when every hot path uses UniformIds
 		std::uint64_t uniformLookups() const { return m_uniformLookups; }
 		std::uint64_t uniformGLQueries() const { return m_uniformGLQueries; }
+		std::uint64_t uniformTableLookups() const { return m_uniformTableLookups; }
 
 	private:
-		mutable std::uint64_t m_uniformLookups = 0; // number of uniformLoc call
-		mutable std::uint64_t m_uniformGLQueries = 0; // number of glGetUniformLocation find call
+		mutable std::uint64_t m_uniformLookups = 0; // number of string-keyed lookups (by-name setters)
+		mutable std::uint64_t m_uniformGLQueries = 0; // number of glGetUniformLocation calls, link time only
+		mutable std::uint64_t m_uniformTableLookups = 0; // number of UniformId table lookups
 
-		mutable std::unordered_map<std::string, GLint> m_locCache;
+		std::vector<std::int32_t> m_slots; // UniformId::index -> m_uniforms index, -1 if inactive
+		std::vector<UniformInfo> m_uniforms;
+		mutable std::vector<std::uint32_t> m_shadow;      // last uploaded values, 32-bit words
+		mutable std::vector<std::uint32_t> m_shadowSet;   // per uniform: words last written, 0 = unknown
 		GLuint m_program = 0;
-		GLint uniformLoc(const char* name) const;
+		std::uint32_t m_sortId = RenderIds::acquire(RenderIdKind::Shader);
+		const UniformInfo* info(UniformId id) const {
+			m_uniformTableLookups++;
+			if (id.index >= m_slots.size() || m_slots[id.index] < 0) return nullptr;
+			return &m_uniforms[(std::size_t)m_slots[id.index]];
+		}
+		// location to upload to, or -1 when the value is unchanged (or inactive)
+		GLint changed(UniformId id, const void* data, std::uint32_t words) const;
+		UniformId nameId(const char* name) const;
+		void reflectUniforms();
+		static void bindUniformBlocks(GLuint prog);
 		static GLuint compile(GLenum type, const char* src);
 		static GLuint link(GLuint vsId, GLuint fsId);
 	};
-}
\ No newline at end of file
+}
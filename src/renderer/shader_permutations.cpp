@@ -0,0 +1,56 @@
+#include "renderer/shader_permutations.h"
+#include <iostream>
+#include <utility>
+
+namespace argon {
+
+	ShaderPermutations::ShaderPermutations(std::string vsSrc, std::string fsSrc)
+		: m_vs(std::move(vsSrc)), m_fs(std::move(fsSrc)) {
+	}
+
+	std::string ShaderPermutations::expand(const std::string& src, std::uint32_t features) {
+		std::string defines;
+		if (features & kShaderTextured) defines += "#define ARGON_TEXTURED 1\n";
+		if (features & kShaderTinted) defines += "#define ARGON_TINTED 1\n";
+		if (features & kShaderAlphaTest) defines += "#define ARGON_ALPHA_TEST 1\n#define ARGON_ALPHA_CUTOFF 0.5\n";
+
+		// #version has to stay the first directive
+		std::size_t at = 0;
+		const std::size_t version = src.find("#version");
+		if (version != std::string::npos) {
+			const std::size_t eol = src.find('\n', version);
+			at = eol == std::string::npos ? src.size() : eol + 1;
+		}
+		std::string out;
+		out.reserve(src.size() + defines.size() + 1);
+		out.append(src, 0, at);
+		if (at > 0 && out.back() != '\n') out += '\n';
+		out += defines;
+		out.append(src, at, std::string::npos);
+		return out;
+	}
+
+	const Shader* ShaderPermutations::variant(std::uint32_t features) {
+		const std::uint32_t idx = features & kShaderFeatureMask;
+		if (m_variants[idx] || m_tried[idx]) return m_variants[idx].get();
+		m_tried[idx] = true;
+
+		const std::string vs = expand(m_vs, idx);
+		const std::string fs = expand(m_fs, idx);
+		auto shader = std::make_unique<Shader>(vs.c_str(), fs.c_str());
+		if (!shader->id()) {
+			std::cerr << "Failed to build shader variant, features=0x" << std::hex << idx << std::dec << "\n";
+			m_stats.failures++;
+			return nullptr;
+		}
+		m_variants[idx] = std::move(shader);
+		m_stats.variants++;
+		return m_variants[idx].get();
+	}
+
+	bool ShaderPermutations::prewarm() {
+		bool ok = true;
+		for (std::uint32_t f = 0; f < kVariants; ++f) ok = variant(f) != nullptr && ok;
+		return ok;
+	}
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "renderer/shader.h"
+
+namespace argon {
+
+	// Compile-time material features. Each set bit adds a #define to the
+	// variant, so fragment shaders pick their path with #ifdef instead of
+	// branching on a uniform.
+	enum ShaderFeature : std::uint32_t {
+		kShaderTextured = 1u << 0,  // ARGON_TEXTURED: multiply by texture(uTex, uv)
+		kShaderTinted = 1u << 1,    // ARGON_TINTED: multiply by material color * entity tint; off ignores both
+		kShaderAlphaTest = 1u << 2, // ARGON_ALPHA_TEST: discard below ARGON_ALPHA_CUTOFF
+	};
+	static constexpr std::uint32_t kShaderFeatureBits = 3;
+	static constexpr std::uint32_t kShaderFeatureMask = (1u << kShaderFeatureBits) - 1;
+
+	// One vertex/fragment source pair compiled once per feature mask in use.
+	// Variants are built on first request (through the program binary cache,
+	// when enabled) and kept in a flat table indexed by the mask. Each variant
+	// is its own Shader, so its sort id keeps different variants in different
+	// sort groups and batches. GL thread only.
+	class ShaderPermutations {
+	public:
+		struct Stats {
+			std::uint32_t variants = 0; // compiled and linked
+			std::uint32_t failures = 0;
+		};
+
+		ShaderPermutations(std::string vsSrc, std::string fsSrc);
+
+		ShaderPermutations(const ShaderPermutations&) = delete;
+		ShaderPermutations& operator=(const ShaderPermutations&) = delete;
+
+		// nullptr if the variant failed to build; a failure is not retried
+		const Shader* variant(std::uint32_t features);
+		// compiles every variant up front instead of on first use
+		bool prewarm();
+
+		const Stats& stats() const { return m_stats; }
+
+		// src with the feature #defines inserted after its #version line
+		static std::string expand(const std::string& src, std::uint32_t features);
+
+	private:
+		static constexpr std::size_t kVariants = std::size_t(1) << kShaderFeatureBits;
+
+		std::string m_vs;
+		std::string m_fs;
+		std::array<std::unique_ptr<Shader>, kVariants> m_variants;
+		std::array<bool, kVariants> m_tried{};
+		Stats m_stats;
+	};
+}
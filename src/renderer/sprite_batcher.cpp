@@ -1,20 +1,64 @@
 #include "renderer/sprite_batcher.h"
 #include <glad/glad.h>
 #include <cstring>
+#include <cstddef>
 
 #include "renderer/shader.h"
 #include "renderer/mesh.h"
 #include "renderer/texture2d.h"
+#include "renderer/gl_extensions.h"
+#include "math/half.h"
+#include "renderer/gl_state_tracker.h"
 
 namespace argon {
 	
 	static constexpr std::size_t kMaxBatchedSprites = 20000;
-	void SpriteBatcher::begin(const Mat4& PV, StatsSink sink) {
-		m_PV = PV;
+	static const UniformId kTexUniform = UniformId::of("uTex");
+
+	// quad position 0 and uv 1, plus per-instance attributes by layout:
+	// Full: mat4 in 2..5, color 6, uv 7, slot 8.
+	// Compact: translate 2, linear 3, color 6, uv 7, slot 8.
+	// Trs: position 2, rotation 3, scale 4, color 6, uv 7, slot 8.
+	static void enableLayoutAttribs(SpriteInstanceLayout layout, GLuint quadVBO) {
+		static const int kFullLocs[] = { 2, 3, 4, 5, 6, 7, 8 };
+		static const int kCompactLocs[] = { 2, 3, 6, 7, 8 };
+		static const int kTrsLocs[] = { 2, 3, 4, 6, 7, 8 };
+		static const int* const kLocs[] = { kFullLocs, kCompactLocs, kTrsLocs };
+		static const int kLocCounts[] = { 7, 5, 6 };
+
+		glState().bindArrayBuffer(quadVBO);
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+
+		for (int i = 0; i < kLocCounts[(int)layout]; ++i) {
+			glEnableVertexAttribArray(kLocs[(int)layout][i]);
+			glVertexAttribDivisor(kLocs[(int)layout][i], 1);
+		}
+	}
+
+	void SpriteBatcher::beginFrame() {
+		m_ring.beginFrame();
+	}
+
+	void SpriteBatcher::endFrame() {
+		m_ring.endFrame();
+	}
+
+	void SpriteBatcher::begin(StatsSink sink) {
 		m_sink = sink;
-		m_instances.clear();
+		m_layout = effectiveLayout();
+		m_count = 0;
 		m_hasBatch = false;
-		m_batchKey = 0;
+		m_slotCount = 0;
+		m_lastSlot = 0;
+	}
+
+	SpriteInstanceLayout SpriteBatcher::effectiveLayout() const {
+		if (m_requestedLayout == SpriteInstanceLayout::Compact && m_compactSpriteShader) return SpriteInstanceLayout::Compact;
+		if (m_requestedLayout == SpriteInstanceLayout::Trs && m_trsSpriteShader) return SpriteInstanceLayout::Trs;
+		return SpriteInstanceLayout::Full;
 	}
 
 	bool SpriteBatcher::canInstance(const Mesh* mesh, const Material2D& material) const {
@@ -22,42 +66,184 @@ namespace argon {
 			   (m_instancedSpriteShader && material.shader == m_instancedSpriteShader);
 	}
 
-	void SpriteBatcher::submit(std::uint64_t key, const Material2D& material, const Mat4& model,
-							   const Vec4 & tint, const Vec4& uvRect) {
+	void SpriteBatcher::openWrite() {
+		initInstancingGL();
+		const std::size_t stride = instanceStride();
+		std::uint8_t* p = m_ring.beginWrite(m_ring.remaining(stride), stride);
+		if (!p) {
+			// this frame filled its segment: double it, the new buffer starts empty
+			m_ring.grow(m_ring.segmentBytes() * 2);
+			p = m_ring.beginWrite(m_ring.remaining(stride), stride);
+		}
+		m_write = p;
+		m_writeCapacity = p ? m_ring.remaining() / stride : 0;
+	}
+
+	std::uint32_t SpriteBatcher::slotFor(const Texture2D* tex, GLStateTracker& st) {
+		// sorted input: consecutive sprites almost always hit the last slot
+		if (m_slotCount && m_slots[m_lastSlot] == tex) return (std::uint32_t)m_lastSlot;
+		for (int i = 0; i < m_slotCount; ++i) {
+			if (m_slots[i] == tex) { m_lastSlot = i; return (std::uint32_t)i; }
+		}
+		// out of units => draw what we have, the batch continues with fresh slots
+		if (m_slotCount == kTextureSlots) {
+			if (m_count) flushInternal(st);
+			m_slotCount = 0;
+		}
+		m_slots[m_slotCount] = tex;
+		m_lastSlot = m_slotCount++;
+		return (std::uint32_t)m_lastSlot;
+	}
+
+	void SpriteBatcher::closeWrite() {
+		if (!m_write) return;
+		m_ring.endWrite(0);
+		m_write = nullptr;
+		m_writeCapacity = 0;
+	}
+
+	std::uint8_t* SpriteBatcher::reserveInstance(const Material2D& material, GLStateTracker& st, std::uint32_t& slot) {
+		initInstancingGL();
+
 		// start
 		if (!m_hasBatch) {
 			m_hasBatch = true;
-			m_batchKey = key;
 			m_batchMaterial = material;
+			m_slotCount = 0;
+		}
+
+		slot = slotFor(spriteTexture(material), st);
+
+		// segment full => draw what we have and continue the same batch
+		if (m_write && m_count == m_writeCapacity) {
+			flushInternal(st);
+		}
+		if (!m_write) {
+			openWrite();
+			if (!m_write) return nullptr;
+		}
+		return m_write + m_count * instanceStride();
+	}
+
+	const Texture2D* SpriteBatcher::spriteTexture(const Material2D& material) {
+		if (material.textured()) return material.texture;
+		initInstancingGL();
+		return m_whiteTex.get();
+	}
+
+	std::size_t SpriteBatcher::instanceSize(SpriteInstanceLayout layout) {
+		switch (layout) {
+		case SpriteInstanceLayout::Compact: return sizeof(CompactInstanceData);
+		case SpriteInstanceLayout::Trs: return sizeof(TrsInstanceData);
+		default: return sizeof(InstanceData);
+		}
+	}
+
+	void SpriteBatcher::packInstance(SpriteInstanceLayout layout, const Material2D& material, const Affine2D& model,
+									 const Vec4& tint, const Vec4& uvRect, std::uint32_t slot, std::uint8_t* dst) {
+		if (layout == SpriteInstanceLayout::Trs) {
+			packInstance(layout, material, Transform::fromAffine(model), tint, uvRect, slot, dst);
+			return;
+		}
+
+		const Affine2D& M = model;
+		const float r = material.color.r * tint.r;
+		const float g = material.color.g * tint.g;
+		const float b = material.color.b * tint.b;
+		const float a = material.color.a * tint.a;
+
+		// mapped memory is write-combined: build on the stack, write each instance once
+		if (layout == SpriteInstanceLayout::Compact) {
+			CompactInstanceData inst;
+			inst.translate[0] = M.tx;
+			inst.translate[1] = M.ty;
+			inst.linear[0] = floatToHalf(M.a);
+			inst.linear[1] = floatToHalf(M.b);
+			inst.linear[2] = floatToHalf(M.c);
+			inst.linear[3] = floatToHalf(M.d);
+			inst.color[0] = unorm8(r);
+			inst.color[1] = unorm8(g);
+			inst.color[2] = unorm8(b);
+			inst.color[3] = unorm8(a);
+			inst.uvRect[0] = unorm16(uvRect.r);
+			inst.uvRect[1] = unorm16(uvRect.g);
+			inst.uvRect[2] = unorm16(uvRect.b);
+			inst.uvRect[3] = unorm16(uvRect.a);
+			inst.texSlot = slot;
+			std::memcpy(dst, &inst, sizeof(inst));
+		}
+		else {
+			// the full layout still takes a mat4: expand the affine here
+			InstanceData inst;
+			inst.m0[0] = M.a;  inst.m0[1] = M.b;  inst.m0[2] = 0.0f; inst.m0[3] = 0.0f;
+			inst.m1[0] = M.c;  inst.m1[1] = M.d;  inst.m1[2] = 0.0f; inst.m1[3] = 0.0f;
+			inst.m2[0] = 0.0f; inst.m2[1] = 0.0f; inst.m2[2] = 1.0f; inst.m2[3] = 0.0f;
+			inst.m3[0] = M.tx; inst.m3[1] = M.ty; inst.m3[2] = 0.0f; inst.m3[3] = 1.0f;
+
+			inst.color[0] = r;
+			inst.color[1] = g;
+			inst.color[2] = b;
+			inst.color[3] = a;
+
+			inst.uvRect[0] = uvRect.r;
+			inst.uvRect[1] = uvRect.g;
+			inst.uvRect[2] = uvRect.b;
+			inst.uvRect[3] = uvRect.a;
+			inst.texSlot = slot;
+			std::memcpy(dst, &inst, sizeof(inst));
+		}
+	}
+
+	void SpriteBatcher::packInstance(SpriteInstanceLayout layout, const Material2D& material, const Transform& trs,
+									 const Vec4& tint, const Vec4& uvRect, std::uint32_t slot, std::uint8_t* dst) {
+		if (layout != SpriteInstanceLayout::Trs) {
+			packInstance(layout, material, trs.affine(), tint, uvRect, slot, dst);
+			return;
 		}
-		// key changed => flush then start new batch
-		InstanceData inst{};
-		const Mat4& M = model;
-		std::memcpy(inst.m0, &M.m[0], 4 * sizeof(float));
-		std::memcpy(inst.m1, &M.m[4], 4 * sizeof(float));
-		std::memcpy(inst.m2, &M.m[8], 4 * sizeof(float));
-		std::memcpy(inst.m3, &M.m[12], 4 * sizeof(float));
 
-		inst.color[0] = material.color.r * tint.r;
-		inst.color[1] = material.color.g * tint.g;
-		inst.color[2] = material.color.b * tint.b;
-		inst.color[3] = material.color.a * tint.a;
+		TrsInstanceData inst;
+		inst.pos[0] = trs.x;
+		inst.pos[1] = trs.y;
+		inst.rotation = trs.rotation;
+		inst.scale[0] = trs.sx;
+		inst.scale[1] = trs.sy;
+		inst.color[0] = unorm8(material.color.r * tint.r);
+		inst.color[1] = unorm8(material.color.g * tint.g);
+		inst.color[2] = unorm8(material.color.b * tint.b);
+		inst.color[3] = unorm8(material.color.a * tint.a);
+		inst.uvRect[0] = unorm16(uvRect.r);
+		inst.uvRect[1] = unorm16(uvRect.g);
+		inst.uvRect[2] = unorm16(uvRect.b);
+		inst.uvRect[3] = unorm16(uvRect.a);
+		inst.texSlot = slot;
+		std::memcpy(dst, &inst, sizeof(inst));
+	}
 
-		inst.uvRect[0] = uvRect.r;
-		inst.uvRect[1] = uvRect.g;
-		inst.uvRect[2] = uvRect.b;
-		inst.uvRect[3] = uvRect.a;
+	void SpriteBatcher::submit(const Material2D& material, const Affine2D& model,
+							   const Vec4 & tint, const Vec4& uvRect, GLStateTracker& st) {
+		std::uint32_t slot = 0;
+		std::uint8_t* dst = reserveInstance(material, st, slot);
+		if (!dst) return;
+		packInstance(m_layout, material, model, tint, uvRect, slot, dst);
+		m_count++;
+	}
 
-		m_instances.push_back(inst);
+	void SpriteBatcher::submit(const Material2D& material, const Transform& trs,
+							   const Vec4& tint, const Vec4& uvRect, GLStateTracker& st) {
+		std::uint32_t slot = 0;
+		std::uint8_t* dst = reserveInstance(material, st, slot);
+		if (!dst) return;
+		packInstance(m_layout, material, trs, tint, uvRect, slot, dst);
+		m_count++;
 	}
 
-	void SpriteBatcher::flush(RenderStateCache& st) {
+	void SpriteBatcher::flush(GLStateTracker& st) {
 		if (!m_hasBatch) return;
-		if (m_instances.empty()) { m_hasBatch = false; return; }
-		if (!m_batchMaterial.shader) { m_instances.clear(); m_hasBatch = false; return; }
+		if (m_count == 0) { closeWrite(); m_hasBatch = false; return; }
+		if (!m_batchMaterial.shader) { closeWrite(); m_count = 0; m_hasBatch = false; return; }
 		flushInternal(st);
-		m_instances.clear();
 		m_hasBatch = false;
+		m_slotCount = 0;
 
 	}
 
@@ -73,117 +259,179 @@ namespace argon {
 			-0.5f, 0.5f, 0.f,1.f,
 		};
 
-		glGenVertexArrays(1, &m_vao);
-		glBindVertexArray(m_vao);
-
 		glGenBuffers(1, &m_quadVBO);
-		glBindBuffer(GL_ARRAY_BUFFER, m_quadVBO);
+		glState().bindArrayBuffer(m_quadVBO);
 		glBufferData(GL_ARRAY_BUFFER, sizeof(quadVerts), quadVerts, GL_STATIC_DRAW);
 
-		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-
-		glGenBuffers(1, &m_instanceVBO);
-		glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
-
-		m_capacity = kMaxBatchedSprites;
-		glBufferData(GL_ARRAY_BUFFER,
-			(GLsizeiptr)(m_capacity * sizeof(InstanceData)),
-			nullptr,
-			GL_DYNAMIC_DRAW);
-
-		const GLsizei stride = (GLsizei)sizeof(InstanceData);
-
-		for (int i = 0; i < 4; ++i) {
-			glEnableVertexAttribArray(2 + i);
-			glVertexAttribPointer(2 + i, 4, GL_FLOAT, GL_FALSE, stride, (void*)(i * 4 * sizeof(float)));
-			glVertexAttribDivisor(2 + i, 1);
+		glGenVertexArrays(3, m_vaos);
+		for (int layout = 0; layout < 3; ++layout) {
+			glState().bindVertexArray(m_vaos[layout]);
+			enableLayoutAttribs((SpriteInstanceLayout)layout, m_quadVBO);
 		}
 
-		glEnableVertexAttribArray(6);
-		glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, stride, (void*)(16 * sizeof(float)));
-		glVertexAttribDivisor(6, 1);
+		glState().bindArrayBuffer(0);
+		glState().bindVertexArray(0);
 
-		glEnableVertexAttribArray(7);
-		glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, stride, (void*)(20 * sizeof(float)));
-		glVertexAttribDivisor(7, 1);
+		m_ring.init(kMaxBatchedSprites * sizeof(InstanceData));
+		m_attribBuffer[0] = m_attribBuffer[1] = m_attribBuffer[2] = 0;
 
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-		glBindVertexArray(0);
+		const std::uint32_t white = 0xFFFFFFFFu;
+		m_whiteTex = std::make_unique<Texture2D>(1, 1, &white);
 
 		m_inited = true;
 	}
 
-	void SpriteBatcher::flushInternal(RenderStateCache& st) {
-		initInstancingGL();
-		const Material2D& material = m_batchMaterial;
-		const Shader& shader = *material.shader;
-		const std::uint32_t shaderId = (std::uint32_t)shader.id();
-		if (shaderId != st.shaderId) {
-			shader.use();
-			shader.setInt("uTex", 0);
-			st.shaderId = shaderId;
-			if (m_sink.shaderBinds) (*m_sink.shaderBinds)++;
+	void SpriteBatcher::setInstanceAttribs(SpriteInstanceLayout layout, std::size_t baseOffset) {
+		if (layout == SpriteInstanceLayout::Compact) {
+			const GLsizei stride = (GLsizei)sizeof(CompactInstanceData);
+			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride,
+				(void*)(baseOffset + offsetof(CompactInstanceData, translate)));
+			glVertexAttribPointer(3, 4, GL_HALF_FLOAT, GL_FALSE, stride,
+				(void*)(baseOffset + offsetof(CompactInstanceData, linear)));
+			glVertexAttribPointer(6, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+				(void*)(baseOffset + offsetof(CompactInstanceData, color)));
+			glVertexAttribPointer(7, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride,
+				(void*)(baseOffset + offsetof(CompactInstanceData, uvRect)));
+			glVertexAttribIPointer(8, 1, GL_UNSIGNED_INT, stride,
+				(void*)(baseOffset + offsetof(CompactInstanceData, texSlot)));
+		}
+		else if (layout == SpriteInstanceLayout::Trs) {
+			const GLsizei stride = (GLsizei)sizeof(TrsInstanceData);
+			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, stride,
+				(void*)(baseOffset + offsetof(TrsInstanceData, pos)));
+			glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride,
+				(void*)(baseOffset + offsetof(TrsInstanceData, rotation)));
+			glVertexAttribPointer(4, 2, GL_FLOAT, GL_FALSE, stride,
+				(void*)(baseOffset + offsetof(TrsInstanceData, scale)));
+			glVertexAttribPointer(6, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride,
+				(void*)(baseOffset + offsetof(TrsInstanceData, color)));
+			glVertexAttribPointer(7, 4, GL_UNSIGNED_SHORT, GL_TRUE, stride,
+				(void*)(baseOffset + offsetof(TrsInstanceData, uvRect)));
+			glVertexAttribIPointer(8, 1, GL_UNSIGNED_INT, stride,
+				(void*)(baseOffset + offsetof(TrsInstanceData, texSlot)));
+		}
+		else {
+			const GLsizei stride = (GLsizei)sizeof(InstanceData);
+			for (int i = 0; i < 4; ++i) {
+				glVertexAttribPointer(2 + i, 4, GL_FLOAT, GL_FALSE, stride, (void*)(baseOffset + i * 4 * sizeof(float)));
+			}
+			glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, stride, (void*)(baseOffset + 16 * sizeof(float)));
+			glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, stride, (void*)(baseOffset + 20 * sizeof(float)));
+			glVertexAttribIPointer(8, 1, GL_UNSIGNED_INT, stride,
+				(void*)(baseOffset + offsetof(InstanceData, texSlot)));
 		}
+	}
 
-		shader.setMat4("uPV", m_PV.m);
+	// expects layoutVao() bound
+	void SpriteBatcher::bindInstanceAttribs(std::size_t baseOffset) {
+		glState().bindArrayBuffer(m_ring.buffer());
+		setInstanceAttribs(m_layout, baseOffset);
+		m_attribBuffer[(int)m_layout] = m_ring.buffer();
+	}
 
-		const bool wantTex = (material.useTexture && material.texture);
-		shader.setInt("uUseTex", wantTex ? 1 : 0);
+	const Shader* SpriteBatcher::shaderFor(SpriteInstanceLayout layout, const Material2D& material) const {
+		if (layout == SpriteInstanceLayout::Compact && m_compactSpriteShader) return m_compactSpriteShader;
+		if (layout == SpriteInstanceLayout::Trs && m_trsSpriteShader) return m_trsSpriteShader;
+		return material.shader;
+	}
 
-		const std::uint32_t texId = wantTex ? (std::uint32_t)material.texture->id() : 0;
-		if (wantTex) {
-			if (texId != st.textureId) {
-				material.texture->bind(0);
-				st.textureId = texId;
-				if (m_sink.textureBinds) (*m_sink.textureBinds)++;
-			}
+	void SpriteBatcher::bindShader(const Shader& shader, GLStateTracker& st) {
+		if (st.useProgram(shader.id())) {
+			static const int kUnits[kTextureSlots] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+			shader.setIntArray(kTexUniform, kUnits, kTextureSlots);
+			if (m_sink.shaderBinds) (*m_sink.shaderBinds)++;
 		}
-		else {
-			if (st.textureId != 0) {
-				glActiveTexture(GL_TEXTURE0);
-				glBindTexture(GL_TEXTURE_2D, 0);
-				st.textureId = 0;
+	}
+
+	void SpriteBatcher::bindTextures(const Texture2D* const* textures, int count, GLStateTracker& st) {
+		for (int i = 0; i < count; ++i) {
+			if (st.bindTexture(i, GL_TEXTURE_2D, textures[i]->id())) {
 				if (m_sink.textureBinds) (*m_sink.textureBinds)++;
 			}
 		}
+	}
 
-		const std::uint32_t vaoId = (std::uint32_t)m_vao;
-		if (vaoId != st.vaoId) {
-			glBindVertexArray(m_vao);
-			st.vaoId = vaoId;
+	void SpriteBatcher::bindSlots(GLStateTracker& st) {
+		bindTextures(m_slots, m_slotCount, st);
+	}
+
+	void SpriteBatcher::flushInternal(GLStateTracker& st) {
+		const std::size_t needed = m_count;
+		const std::size_t stride = instanceStride();
+		const std::size_t offset = m_ring.endWrite(needed * stride);
+		m_write = nullptr;
+		m_writeCapacity = 0;
+		m_count = 0;
+
+		bindShader(*shaderFor(m_layout, m_batchMaterial), st);
+		bindSlots(st);
+
+		if (st.bindVertexArray(layoutVao())) {
 			if (m_sink.vaoBinds) (*m_sink.vaoBinds)++;
 		}
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
-
-		const std::size_t needed = m_instances.size();
-		if (needed > m_capacity) {
-			while (needed > m_capacity) m_capacity *= 2;
-			glBufferData(GL_ARRAY_BUFFER,
-				(GLsizeiptr)(m_capacity * sizeof(InstanceData)),
-				nullptr,
-				GL_DYNAMIC_DRAW);
+		// base instance: attribs stay at offset 0 and the draw picks the slice,
+		// plain GL 3.3: re-point the instance attribs at this batch's slice
+		const GLExtensions& ext = glExt();
+		if (ext.baseInstance) {
+			if (m_attribBuffer[(int)m_layout] != m_ring.buffer()) bindInstanceAttribs(0);
+			ext.DrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, 6, (GLsizei)needed,
+												(GLuint)(offset / stride));
 		}
 		else {
-			glBufferData(GL_ARRAY_BUFFER,
-				(GLsizeiptr)(m_capacity * sizeof(InstanceData)),
-				nullptr,
-				GL_DYNAMIC_DRAW);
+			bindInstanceAttribs(offset);
+			glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)needed);
 		}
 
-		glBufferSubData(GL_ARRAY_BUFFER,
-			0,
-			(GLsizeiptr)(needed * sizeof(InstanceData)),
-			m_instances.data());
-
-		glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)needed);
-
 		if (m_sink.drawCalls) (*m_sink.drawCalls)++;
 		if (m_sink.batchFlushes) (*m_sink.batchFlushes)++;
 		if (m_sink.batchedVerts) (*m_sink.batchedVerts) += (std::uint32_t)(needed * 6);
+		if (m_sink.instanceBytes) (*m_sink.instanceBytes) += (std::uint32_t)(needed * stride);
+	}
+
+	unsigned int SpriteBatcher::createInstanceVao(SpriteInstanceLayout layout, unsigned int buffer) {
+		initInstancingGL();
+
+		GLuint vao = 0;
+		glGenVertexArrays(1, &vao);
+		glState().bindVertexArray(vao);
+		enableLayoutAttribs(layout, m_quadVBO);
+		glState().bindArrayBuffer(buffer);
+		setInstanceAttribs(layout, 0);
+
+		glState().bindArrayBuffer(0);
+		glState().bindVertexArray(0);
+		return vao;
+	}
+
+	void SpriteBatcher::drawBaked(SpriteInstanceLayout layout, const Material2D& material,
+								  unsigned int vao, unsigned int buffer,
+								  const Texture2D* const* textures, int textureCount,
+								  std::uint32_t first, std::uint32_t count, GLStateTracker& st) {
+		if (count == 0) return;
+		const Shader* shader = shaderFor(layout, material);
+		if (!shader) return;
+
+		bindShader(*shader, st);
+		bindTextures(textures, textureCount, st);
+
+		if (st.bindVertexArray(vao)) {
+			if (m_sink.vaoBinds) (*m_sink.vaoBinds)++;
+		}
+
+		const GLExtensions& ext = glExt();
+		if (ext.baseInstance) {
+			ext.DrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, 6, (GLsizei)count, (GLuint)first);
+		}
+		else {
+			// the VAO keeps pointing at this range until the next baked draw re-points it
+			st.bindArrayBuffer(buffer);
+			setInstanceAttribs(layout, (std::size_t)first * instanceSize(layout));
+			glDrawArraysInstanced(GL_TRIANGLES, 0, 6, (GLsizei)count);
+		}
+
+		if (m_sink.drawCalls) (*m_sink.drawCalls)++;
+		if (m_sink.batchedVerts) (*m_sink.batchedVerts) += count * 6;
 	}
 
 }
\ No newline at end of file
@@ -1,17 +1,36 @@
 #pragma once
 #include <vector>
 #include <cstdint>
+#include <memory>
 #include "math/mat4.h"
+#include "math/affine2d.h"
+#include "math/transform.h"
 #include "renderer/material2d.h"
-#include "renderer/render_state_cache.h"
+#include "renderer/gl_state_tracker.h"
+#include "renderer/instance_ring_buffer.h"
 
 namespace argon {
 
 	class Mesh;
 	class Shader;
+	class Texture2D;
 
+	// Full: 100 bytes, column-major mat4 + float4 color + float4 uvRect + texture slot.
+	// Compact: 32 bytes, 2x3 affine (float translation, half 2x2) + RGBA8 color
+	// + unorm16 uvRect + texture slot; needs the compact instanced shader variant.
+	// Trs: 36 bytes, the raw Transform fields (x, y, rotation, sx, sy) + RGBA8
+	// color + unorm16 uvRect + texture slot; the vertex shader builds the model
+	// transform, so the CPU does no trig or matrix math for these sprites.
+	enum class SpriteInstanceLayout : std::uint8_t { Full = 0, Compact, Trs };
+
+	// One batch spans up to kTextureSlots textures: each is bound to its own unit
+	// and instances carry the slot index; the instanced fragment shader samples
+	// uTex[slot]. Untextured sprites use a 1x1 white texture, so a batch only
+	// ends on a shader change or when a ninth distinct texture shows up.
 	class SpriteBatcher {
 	public:
+		static constexpr int kTextureSlots = GLStateTracker::kTextureUnits;
+
 		struct StatsSink {
 			std::uint32_t* drawCalls = nullptr;
 			std::uint32_t* shaderBinds = nullptr;
@@ -19,17 +38,61 @@ namespace argon {
 			std::uint32_t* vaoBinds = nullptr;
 			std::uint32_t* batchFlushes = nullptr;
 			std::uint32_t* batchedVerts = nullptr;
+			std::uint32_t* instanceBytes = nullptr;
 		};
 
 		void setSpriteQuad(const Mesh* quad) { m_spriteQuad = quad; }
 		void setInstancedSpriteShader(const Shader* s) { m_instancedSpriteShader = s; }
+		// program drawing the Compact layout, materials still reference the full sprite shader
+		void setCompactSpriteShader(const Shader* s) { m_compactSpriteShader = s; }
+		// program drawing the Trs layout
+		void setTrsSpriteShader(const Shader* s) { m_trsSpriteShader = s; }
+
+		// takes effect at the next begin(); Compact/Trs without their shader fall back to Full
+		void setInstanceLayout(SpriteInstanceLayout layout) { m_requestedLayout = layout; }
+		SpriteInstanceLayout instanceLayout() const { return m_layout; }
+		// the layout the next begin() resolves to
+		SpriteInstanceLayout effectiveLayout() const;
+		// true when sprites of this mesh are expanded in the vertex shader from the
+		// next begin() on, i.e. callers may submit Transform fields instead of a model
+		bool expandsTransformOnGpu(const Mesh* mesh) const {
+			return m_requestedLayout == SpriteInstanceLayout::Trs && m_trsSpriteShader &&
+				   m_spriteQuad && mesh == m_spriteQuad;
+		}
 
-		void begin(const Mat4& PV, StatsSink sink);
+		// frame boundaries of the instance ring (one segment per frame in flight)
+		void beginFrame();
+		void endFrame();
+		std::uint32_t takeFenceWaits() { return m_ring.takeFenceWaits(); }
+
+		// the shaders read uPV from the PassConstants block
+		void begin(StatsSink sink);
 		bool canInstance(const Mesh* mesh, const Material2D& material) const;
-		void submit(std::uint64_t key, const Material2D& material, const Mat4& model,
-					const Vec4& tint, const Vec4& uvRect);
+		void submit(const Material2D& material, const Affine2D& model,
+					const Vec4& tint, const Vec4& uvRect, GLStateTracker& st);
+		// raw fields; expanded on the CPU unless the Trs layout is active
+		void submit(const Material2D& material, const Transform& trs,
+					const Vec4& tint, const Vec4& uvRect, GLStateTracker& st);
+
+		void flush(GLStateTracker& st);
 
-		void flush(RenderStateCache& st);
+		// Baked instance buffers (StaticSpriteCache) share the instance formats,
+		// shaders and texture slots of the streamed batches.
+		static std::size_t instanceSize(SpriteInstanceLayout layout);
+		static void packInstance(SpriteInstanceLayout layout, const Material2D& material, const Affine2D& model,
+								 const Vec4& tint, const Vec4& uvRect, std::uint32_t slot, std::uint8_t* dst);
+		static void packInstance(SpriteInstanceLayout layout, const Material2D& material, const Transform& trs,
+								 const Vec4& tint, const Vec4& uvRect, std::uint32_t slot, std::uint8_t* dst);
+		// texture a sprite of this material samples (1x1 white when untextured)
+		const Texture2D* spriteTexture(const Material2D& material);
+		// VAO reading the quad plus instances of layout from buffer, offset 0
+		unsigned int createInstanceVao(SpriteInstanceLayout layout, unsigned int buffer);
+		// one instanced draw of [first, first + count) from a baked buffer; call
+		// flush() first, the open batch is not drawn
+		void drawBaked(SpriteInstanceLayout layout, const Material2D& material,
+					   unsigned int vao, unsigned int buffer,
+					   const Texture2D* const* textures, int textureCount,
+					   std::uint32_t first, std::uint32_t count, GLStateTracker& st);
 
 	private:
 		struct InstanceData {
@@ -39,31 +102,79 @@ namespace argon {
 			float m3[4];
 			float color[4];
 			float uvRect[4];
+			std::uint32_t texSlot;
+		};
+
+		struct CompactInstanceData {
+			float translate[2];
+			std::uint16_t linear[4];  // half: column-major 2x2 (m00, m10, m01, m11)
+			std::uint8_t color[4];    // unorm8
+			std::uint16_t uvRect[4];  // unorm16 (u0,v0,u1,v1)
+			std::uint32_t texSlot;
+		};
+		struct TrsInstanceData {
+			float pos[2];
+			float rotation;
+			float scale[2];
+			std::uint8_t color[4];    // unorm8
+			std::uint16_t uvRect[4];  // unorm16 (u0,v0,u1,v1)
+			std::uint32_t texSlot;
 		};
+		static_assert(sizeof(InstanceData) == 100, "full sprite instance must stay 100 bytes");
+		static_assert(sizeof(CompactInstanceData) == 32, "compact sprite instance must stay 32 bytes");
+		static_assert(sizeof(TrsInstanceData) == 36, "trs sprite instance must stay 36 bytes");
+
+		std::size_t instanceStride() const { return instanceSize(m_layout); }
+		unsigned int layoutVao() const { return m_vaos[(int)m_layout]; }
+		const Shader* shaderFor(SpriteInstanceLayout layout, const Material2D& material) const;
+		void bindShader(const Shader& shader, GLStateTracker& st);
+		void bindTextures(const Texture2D* const* textures, int count, GLStateTracker& st);
+		// expects the target VAO and the instance buffer bound
+		static void setInstanceAttribs(SpriteInstanceLayout layout, std::size_t baseOffset);
 
 		void initInstancingGL();
-		void flushInternal(RenderStateCache& st);
+		// batch bookkeeping for one more instance, returns where to write it (null on failure)
+		std::uint8_t* reserveInstance(const Material2D& material, GLStateTracker& st, std::uint32_t& slot);
+		std::uint32_t slotFor(const Texture2D* tex, GLStateTracker& st);
+		void bindSlots(GLStateTracker& st);
+		void openWrite();
+		void closeWrite();
+		void bindInstanceAttribs(std::size_t baseOffset);
+		void flushInternal(GLStateTracker& st);
 
 	private:
 		// per-pass
-		Mat4 m_PV{};
 		StatsSink m_sink{};
 
 		// batching state
 		bool m_hasBatch = false;
-		std::uint64_t m_batchKey = 0;
 		Material2D m_batchMaterial{};
-		std::vector<InstanceData> m_instances;
+
+		// textures of the open batch, index = slot = texture unit
+		const Texture2D* m_slots[kTextureSlots] = {};
+		int m_slotCount = 0;
+		int m_lastSlot = 0;
+
+		SpriteInstanceLayout m_layout = SpriteInstanceLayout::Full;
+		SpriteInstanceLayout m_requestedLayout = SpriteInstanceLayout::Full;
+
+		// open write into the ring: instances go straight to mapped memory
+		std::uint8_t* m_write = nullptr;
+		std::size_t m_writeCapacity = 0;
+		std::size_t m_count = 0;
 
 		// GL
 		bool m_inited = false;
-		unsigned int m_vao = 0;
+		unsigned int m_vaos[3] = {};  // per SpriteInstanceLayout, attrib formats differ
 		unsigned int m_quadVBO = 0;
-		unsigned int m_instanceVBO = 0;
-		std::size_t m_capacity = 0;
+		InstanceRingBuffer m_ring;
+		unsigned int m_attribBuffer[3] = {}; // buffer each layout's instance attribs point at
+		std::unique_ptr<Texture2D> m_whiteTex;
 
 		// matching condition
 		const Shader* m_instancedSpriteShader = nullptr;
+		const Shader* m_compactSpriteShader = nullptr;
+		const Shader* m_trsSpriteShader = nullptr;
 		const Mesh* m_spriteQuad = nullptr;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,156 @@
+#include "renderer/static_sprite_cache.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "renderer/gl_extensions.h"
+#include "renderer/texture2d.h"
+#include "renderer/gl_state_tracker.h"
+
+namespace argon {
+
+	StaticSpriteCache::~StaticSpriteCache() {
+		clear();
+	}
+
+	void StaticSpriteCache::clear() {
+		for (Chunk& c : m_chunks) {
+			glState().forgetVertexArray(c.vao);
+			glState().forgetBuffer(c.buffer);
+			if (c.vao) glDeleteVertexArrays(1, &c.vao);
+			if (c.buffer) glDeleteBuffers(1, &c.buffer);
+		}
+		m_chunks.clear();
+		const std::uint32_t generation = m_stats.generation;
+		m_stats = {};
+		m_stats.generation = generation + 1;
+	}
+
+	// world AABB of the unit sprite quad under the packet's transform
+	static CullRect spriteBounds(const RenderPacket2D& pkt) {
+		const Affine2D m = pkt.gpuTransform ? pkt.trs.affine() : pkt.model;
+		const float ex = 0.5f * (std::abs(m.a) + std::abs(m.c));
+		const float ey = 0.5f * (std::abs(m.b) + std::abs(m.d));
+		return { m.tx - ex, m.ty - ey, m.tx + ex, m.ty + ey };
+	}
+
+	void StaticSpriteCache::bake(const RenderPacket2D* packets, const Material2D* const* materials,
+								 const std::uint64_t* keys, std::uint64_t batchKeyMask, std::size_t count,
+								 SpriteBatcher& batcher) {
+		using clock = std::chrono::steady_clock;
+		const auto t0 = clock::now();
+
+		clear();
+
+		const SpriteInstanceLayout layout = batcher.effectiveLayout();
+		const std::size_t stride = SpriteBatcher::instanceSize(layout);
+		const float invChunk = 1.0f / m_chunkSize;
+
+		// chunk of the sprite center, then draw order inside the chunk
+		struct Item {
+			std::uint64_t cell;
+			std::uint64_t key;
+			std::uint32_t index;
+		};
+		std::vector<Item> items(count);
+		for (std::size_t i = 0; i < count; ++i) {
+			const RenderPacket2D& pkt = packets[i];
+			const float x = pkt.gpuTransform ? pkt.trs.x : pkt.model.tx;
+			const float y = pkt.gpuTransform ? pkt.trs.y : pkt.model.ty;
+			const std::int32_t cx = (std::int32_t)std::floor(x * invChunk);
+			const std::int32_t cy = (std::int32_t)std::floor(y * invChunk);
+			items[i] = { ((std::uint64_t)(std::uint32_t)cx << 32) | (std::uint32_t)cy, keys[i], (std::uint32_t)i };
+		}
+		std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+			if (a.cell != b.cell) return a.cell < b.cell;
+			if (a.key != b.key) return a.key < b.key;
+			return a.index < b.index;
+		});
+
+		const GLExtensions& ext = glExt();
+		std::vector<std::uint8_t> bytes;
+
+		for (std::size_t begin = 0; begin < count;) {
+			std::size_t end = begin + 1;
+			while (end < count && items[end].cell == items[begin].cell) ++end;
+
+			Chunk chunk;
+			chunk.bounds = spriteBounds(packets[items[begin].index]);
+			bytes.resize((end - begin) * stride);
+
+			StaticSpriteRange* range = nullptr;
+			std::uint64_t rangeBatch = 0;
+
+			for (std::size_t k = begin; k < end; ++k) {
+				const std::uint32_t i = items[k].index;
+				const RenderPacket2D& pkt = packets[i];
+				const Material2D& material = *materials[i];
+				const Texture2D* tex = batcher.spriteTexture(material);
+				const std::uint64_t batch = items[k].key & batchKeyMask;
+
+				int slot = -1;
+				if (range && rangeBatch == batch) {
+					for (int t = 0; t < range->textureCount; ++t) {
+						if (range->textures[t] == tex) { slot = t; break; }
+					}
+				}
+				// new draw on a batch change or a ninth texture
+				if (!range || rangeBatch != batch ||
+					(slot < 0 && range->textureCount == GLStateTracker::kTextureUnits)) {
+					chunk.ranges.emplace_back();
+					range = &chunk.ranges.back();
+					range->key = items[k].key;
+					range->material = material;
+					range->first = (std::uint32_t)(k - begin);
+					range->layout = layout;
+					rangeBatch = batch;
+					slot = -1;
+				}
+				if (slot < 0) {
+					slot = range->textureCount++;
+					range->textures[slot] = tex;
+				}
+				range->count++;
+
+				std::uint8_t* dst = bytes.data() + (k - begin) * stride;
+				if (pkt.gpuTransform) {
+					SpriteBatcher::packInstance(layout, material, pkt.trs, pkt.tint, pkt.uvRect, (std::uint32_t)slot, dst);
+				} else {
+					SpriteBatcher::packInstance(layout, material, pkt.model, pkt.tint, pkt.uvRect, (std::uint32_t)slot, dst);
+				}
+
+				const CullRect b = spriteBounds(pkt);
+				chunk.bounds.minX = std::min(chunk.bounds.minX, b.minX);
+				chunk.bounds.minY = std::min(chunk.bounds.minY, b.minY);
+				chunk.bounds.maxX = std::max(chunk.bounds.maxX, b.maxX);
+				chunk.bounds.maxY = std::max(chunk.bounds.maxY, b.maxY);
+			}
+
+			// immutable when the driver allows it, the content only changes by re-baking
+			glGenBuffers(1, &chunk.buffer);
+			glState().bindArrayBuffer(chunk.buffer);
+			if (ext.bufferStorage) {
+				ext.BufferStorage(GL_ARRAY_BUFFER, (GLsizeiptr)bytes.size(), bytes.data(), 0);
+			} else {
+				glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)bytes.size(), bytes.data(), GL_STATIC_DRAW);
+			}
+			glState().bindArrayBuffer(0);
+			chunk.vao = batcher.createInstanceVao(layout, chunk.buffer);
+
+			for (StaticSpriteRange& r : chunk.ranges) {
+				r.vao = chunk.vao;
+				r.buffer = chunk.buffer;
+			}
+
+			m_stats.ranges += (std::uint32_t)chunk.ranges.size();
+			m_stats.sprites += (std::uint32_t)(end - begin);
+			m_stats.bytes += (std::uint32_t)bytes.size();
+			m_chunks.push_back(std::move(chunk));
+			begin = end;
+		}
+
+		m_stats.chunks = (std::uint32_t)m_chunks.size();
+		m_stats.lastBakeMs = std::chrono::duration<float, std::milli>(clock::now() - t0).count();
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "math/aabb_cull.h"
+#include "renderer/material2d.h"
+#include "renderer/render_packet2d.h"
+#include "renderer/gl_state_tracker.h"
+#include "renderer/sprite_batcher.h"
+
+namespace argon {
+
+	class Texture2D;
+
+	// One instanced draw out of a baked chunk: consecutive sprites (in sort key
+	// order) sharing the instance batch key and at most kTextureUnits textures.
+	struct StaticSpriteRange {
+		std::uint64_t key = 0;         // sort key of the first sprite
+		Material2D material;           // batch material, picks the shader
+		const Texture2D* textures[GLStateTracker::kTextureUnits] = {};
+		int textureCount = 0;
+		std::uint32_t first = 0;       // instance index in the chunk buffer
+		std::uint32_t count = 0;
+		SpriteInstanceLayout layout = SpriteInstanceLayout::Full;
+		unsigned int vao = 0;
+		unsigned int buffer = 0;
+	};
+
+	// Sprites that never move, baked into immutable GPU buffers, one per square
+	// world chunk. A bake replaces all content; afterwards a frame costs one
+	// bounds test per chunk and one draw per visible range, nothing per sprite.
+	class StaticSpriteCache {
+	public:
+		struct Stats {
+			std::uint32_t chunks = 0;
+			std::uint32_t ranges = 0;
+			std::uint32_t sprites = 0;
+			std::uint32_t generation = 0;  // bumped by every bake and clear
+			float lastBakeMs = 0.0f;
+			std::uint32_t bytes = 0;       // instance data on the GPU
+		};
+
+		StaticSpriteCache() = default;
+		~StaticSpriteCache();
+
+		StaticSpriteCache(const StaticSpriteCache&) = delete;
+		StaticSpriteCache& operator=(const StaticSpriteCache&) = delete;
+
+		// world units per chunk side, applies at the next bake
+		void setChunkSize(float size) { m_chunkSize = size > 0.0f ? size : 1.0f; }
+		float chunkSize() const { return m_chunkSize; }
+
+		// Replaces the baked content. packets[i] must be instanceable by the
+		// batcher with materials[i]; keys[i] is its renderer sort key and
+		// keys[i] & batchKeyMask the part that has to match within one draw.
+		void bake(const RenderPacket2D* packets, const Material2D* const* materials,
+				  const std::uint64_t* keys, std::uint64_t batchKeyMask, std::size_t count,
+				  SpriteBatcher& batcher);
+		void clear();
+		bool empty() const { return m_chunks.empty(); }
+
+		// calls fn(const StaticSpriteRange&) for every range of every chunk overlapping view
+		template<class Fn>
+		void forEachVisible(const CullRect& view, Fn&& fn) const {
+			for (const Chunk& c : m_chunks) {
+				if (!overlaps(c.bounds, view)) continue;
+				for (const StaticSpriteRange& r : c.ranges) fn(r);
+			}
+		}
+
+		const Stats& stats() const { return m_stats; }
+
+	private:
+		struct Chunk {
+			CullRect bounds;
+			unsigned int buffer = 0;
+			unsigned int vao = 0;
+			std::vector<StaticSpriteRange> ranges;
+		};
+
+		std::vector<Chunk> m_chunks;
+		float m_chunkSize = 8.0f;
+		Stats m_stats;
+	};
+}
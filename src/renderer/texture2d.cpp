@@ -1,41 +1,123 @@
 #include "texture2d.h"
+#include "renderer/cooked_texture_file.h"
+#include "renderer/image_decode.h"
+#include "renderer/gl_state_tracker.h"
+#include <chrono>
+#include <fstream>
 #include <iostream>
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+#include <iterator>
+#include <vector>
 
 namespace argon {
 	
+	using LoadClock = std::chrono::steady_clock;
+
+	static double msSince(LoadClock::time_point t0) {
+		return std::chrono::duration<double, std::milli>(LoadClock::now() - t0).count();
+	}
+
 	Texture2D::Texture2D(const std::string& path) {
-		stbi_set_flip_vertically_on_load(1);
-		unsigned char* data = stbi_load(path.c_str(), &m_w, &m_h, &m_channels, 4);
-		if (!data) {
+		if (CookedTextureFile::isCookedPath(path)) loadCooked(path);
+		else loadImage(path);
+	}
+
+	void Texture2D::loadImage(const std::string& path) {
+		auto t0 = LoadClock::now();
+		std::ifstream in(path, std::ios::binary);
+		std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		m_loadStats.ioMs = msSince(t0);
+		m_loadStats.bytes = bytes.size();
+
+		t0 = LoadClock::now();
+		DecodedImage img = decodeImageRGBA(bytes.data(), bytes.size());
+		m_loadStats.decodeMs = msSince(t0);
+		if (!img.ok()) {
 			std::cerr << "Failed to load texture: " << path << "\n";
 			return;
 		}
+		m_w = img.width;
+		m_h = img.height;
+		m_channels = 4;
 
+		t0 = LoadClock::now();
+		upload(img.pixels.get());
+		m_loadStats.uploadMs = msSince(t0);
+	}
+
+	void Texture2D::loadCooked(const std::string& path) {
+		auto t0 = LoadClock::now();
+		CookedTextureFile file;
+		if (!file.open(path)) return;
+		m_loadStats.ioMs = msSince(t0);
+		m_loadStats.cooked = true;
+
+		const cooked::FileHeader& h = file.header();
+		m_w = (int)h.width;
+		m_h = (int)h.height;
+		m_channels = 4;
+
+		// page faults on the mapping land here, so upload time includes the disk read
+		t0 = LoadClock::now();
+		createTexture(h.mipCount > 1);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)h.mipCount - 1);
+		for (std::uint32_t level = 0; level < h.mipCount; ++level) {
+			const cooked::MipEntry& m = file.mip(level);
+			glTexImage2D(GL_TEXTURE_2D, (GLint)level, GL_RGBA8, (GLsizei)m.width, (GLsizei)m.height, 0,
+						 GL_RGBA, GL_UNSIGNED_BYTE, file.mipData(level));
+			m_loadStats.bytes += m.size;
+		}
+		glState().bindTexture(GL_TEXTURE_2D, 0);
+		m_loadStats.uploadMs = msSince(t0);
+	}
+
+	Texture2D::Texture2D(int width, int height, const void* rgba)
+		: m_w(width), m_h(height), m_channels(4) {
+		upload(rgba);
+	}
+
+	void Texture2D::createTexture(bool mipmapped) {
 		glGenTextures(1, &m_id);
-		glBindTexture(GL_TEXTURE_2D, m_id);
+		glState().bindTexture(GL_TEXTURE_2D, m_id);
 
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmapped ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
 		// Define behavior when UV exceed beyond the range
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	}
+
+	void Texture2D::upload(const void* rgba) {
+		createTexture(false);
+
 		// Pass data to GPU
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_w, m_h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_w, m_h, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+		glState().bindTexture(GL_TEXTURE_2D, 0);
+	}
 
-		stbi_image_free(data);
+	void Texture2D::adoptTexture(GLuint id, int width, int height, const AssetLoadStats& stats) {
+		if (m_id) {
+			glState().forgetTexture(m_id);
+			glDeleteTextures(1, &m_id);
+		}
+		m_id = id;
+		m_w = width;
+		m_h = height;
+		m_channels = 4;
+		m_loadStats = stats;
 	}
 
 	Texture2D::~Texture2D() {
-		if (m_id) glDeleteTextures(1, &m_id);
+		if (m_id) {
+			glState().forgetTexture(m_id);
+			glDeleteTextures(1, &m_id);
+		}
+		RenderIds::release(RenderIdKind::Texture, m_sortId);
 	}
 
 	void Texture2D::bind(int unit) const {
-		glActiveTexture(GL_TEXTURE0 + unit);
-		glBindTexture(GL_TEXTURE_2D, m_id);
+		glState().bindTexture(unit, GL_TEXTURE_2D, m_id);
 	}
 }
\ No newline at end of file
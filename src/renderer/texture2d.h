@@ -1,13 +1,20 @@
 #pragma once
 #include <glad/glad.h>
 #include <string>
+#include <cstdint>
+#include "renderer/render_ids.h"
+#include "renderer/asset_load_stats.h"
 
 namespace argon {
 
 	class Texture2D {
 
 	public:
+		// .atex paths are cooked files (see argon_cook) and upload straight from
+		// the mapping, anything else goes through stb_image
 		explicit Texture2D(const std::string& path);
+		// tightly packed RGBA8 pixels, rows bottom to top
+		Texture2D(int width, int height, const void* rgba);
 		~Texture2D();
 
 		Texture2D(const Texture2D&) = delete;
@@ -15,13 +22,27 @@ namespace argon {
 
 		void bind(int unit = 0) const;
 
+		// Swap in a fully uploaded GL texture (ownership moves here) and drop the
+		// current one. The sort id stays, so materials and keys need no update.
+		void adoptTexture(GLuint id, int width, int height, const AssetLoadStats& stats);
+
 		int width() const { return m_w; }
 		int height() const { return m_h; }
 		unsigned int id() const { return m_id; }
+		std::uint32_t sortId() const { return m_sortId; }
+		const AssetLoadStats& loadStats() const { return m_loadStats; }
+
+	private:
+		void upload(const void* rgba);
+		void loadImage(const std::string& path);
+		void loadCooked(const std::string& path);
+		void createTexture(bool mipmapped);
 
 	private:
 		GLuint m_id = 0;
+		std::uint32_t m_sortId = RenderIds::acquire(RenderIdKind::Texture);
 		int m_w = 0, m_h = 0, m_channels = 0;
+		AssetLoadStats m_loadStats;
 
 	};
 
@@ -1,4 +1,7 @@
 #include "renderer/texture_atlas.h"
+#include "renderer/cooked_texture_file.h"
+#include "renderer/material_library.h"
+#include <chrono>
 #include <fstream>
 #include <sstream>
 
@@ -17,17 +20,57 @@ namespace argon {
 		return { u0, v0, u1, v1 };
 	}
 
-	bool TextureAtlas::loadFromFile(const std::string& path) {
-		std::ifstream in(path);
-		if (!in.is_open()) return false;
+	using LoadClock = std::chrono::steady_clock;
 
+	void TextureAtlas::clearSprites() {
 		m_ids.clear();
 		m_uvById.clear();
+		m_pageById.clear();
 
 		m_uvById.push_back({ 0.0f, 0.0f, 1.0f, 1.0f });
+		m_pageById.push_back(0);
+	}
+
+	bool TextureAtlas::loadFromFile(const std::string& path) {
+		m_loadStats = {};
+		if (CookedTextureFile::isCookedPath(path)) return loadFromCooked(path);
+		return loadFromText(path);
+	}
+
+	bool TextureAtlas::loadFromCooked(const std::string& path) {
+		const auto t0 = LoadClock::now();
+		CookedTextureFile file;
+		if (!file.open(path)) return false;
+
+		const cooked::FileHeader& h = file.header();
+		setTextureSize((int)h.width, (int)h.height);
+		clearSprites();
+		m_ids.reserve(file.rectCount());
+		m_uvById.reserve(file.rectCount() + 1);
+		m_pageById.reserve(file.rectCount() + 1);
+
+		for (std::uint32_t i = 0; i < file.rectCount(); ++i) {
+			const cooked::RectEntry& e = file.rect(i);
+			const AtlasSpriteRectPx r{ e.x, e.y, e.w, e.h };
+			addSprite(std::string(file.rectName(i)), rectPxToUV(m_texW, m_texH, r));
+		}
+
+		m_loadStats.ioMs = std::chrono::duration<double, std::milli>(LoadClock::now() - t0).count();
+		m_loadStats.bytes = (std::uint64_t)file.rectCount() * sizeof(cooked::RectEntry) + h.nameTableSize;
+		m_loadStats.cooked = true;
+		return true;
+	}
+
+	bool TextureAtlas::loadFromText(const std::string& path) {
+		const auto t0 = LoadClock::now();
+		std::ifstream in(path);
+		if (!in.is_open()) return false;
+
+		clearSprites();
 
 		std::string line;
 		while (std::getline(in, line)) {
+			m_loadStats.bytes += line.size() + 1;
 			if (line.empty()) continue;
 			if (line[0] == '#') continue;
 
@@ -41,20 +84,53 @@ namespace argon {
 
 			if (r.w <= 0 || r.h <= 0) continue;
 
-			SpriteId id = 0;
-			auto it = m_ids.find(name);
-			if (it == m_ids.end()) {
-				id = (SpriteId)m_uvById.size();
-				m_ids[name] = id;
-				m_uvById.push_back({ 0,0,1,1 });
-			} else {
-				id = it->second;
-			}
-			m_uvById[id] = rectPxToUV(m_texW, m_texH, r);
+			addSprite(name, rectPxToUV(m_texW, m_texH, r));
 		}
+
+		m_loadStats.decodeMs = std::chrono::duration<double, std::milli>(LoadClock::now() - t0).count();
 		return true;
 	}
 
+	TextureAtlas::SpriteId TextureAtlas::addSprite(const std::string& name, const Vec4& uv, std::uint32_t page) {
+		SpriteId id = 0;
+		auto it = m_ids.find(name);
+		if (it == m_ids.end()) {
+			id = (SpriteId)m_uvById.size();
+			m_ids[name] = id;
+			m_uvById.push_back({ 0,0,1,1 });
+			m_pageById.push_back(0);
+		} else {
+			id = it->second;
+		}
+		m_uvById[id] = uv;
+		m_pageById[id] = page;
+		return id;
+	}
+
+	std::uint32_t TextureAtlas::addPage(std::unique_ptr<Texture2D> texture) {
+		m_pages.push_back(std::move(texture));
+		return (std::uint32_t)m_pages.size() - 1;
+	}
+
+	const Texture2D* TextureAtlas::pageTexture(std::uint32_t page) const {
+		if (page >= m_pages.size()) return nullptr;
+		return m_pages[page].get();
+	}
+
+	void TextureAtlas::setPageMaterial(std::uint32_t page, MaterialHandle material) {
+		if (page >= m_pageMaterials.size()) m_pageMaterials.resize((std::size_t)page + 1, kInvalidMaterial);
+		m_pageMaterials[page] = material;
+	}
+
+	void TextureAtlas::createPageMaterials(MaterialLibrary& materials, const Material2D& base) {
+		for (std::uint32_t page = 1; page < pageCount(); ++page) {
+			if (!m_pages[page] || pageMaterial(page) != kInvalidMaterial) continue;
+			Material2D m = base;
+			m.texture = m_pages[page].get();
+			setPageMaterial(page, materials.add(m));
+		}
+	}
+
 	TextureAtlas::SpriteId TextureAtlas::getId(const std::string& name) const {
 		auto it = m_ids.find(name);
 		if (it == m_ids.end()) return 0;
@@ -67,5 +143,10 @@ namespace argon {
 		return m_uvById[id];
 	}
 
+	std::uint32_t TextureAtlas::page(SpriteId id) const {
+		if (id >= m_pageById.size()) return 0;
+		return m_pageById[id];
+	}
+
 
 }
\ No newline at end of file
@@ -2,11 +2,16 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <memory>
 #include <unordered_map>
-#include "renderer/material2d.h" // Vec4
+#include "renderer/material2d.h" // Vec4, Texture2D
+#include "renderer/material_handle.h"
+#include "renderer/asset_load_stats.h"
 
 namespace argon {
 
+	class MaterialLibrary;
+
 	struct AtlasSpriteRectPx {
 		int x = 0, y = 0, w = 0, h = 0;
 	};
@@ -18,15 +23,47 @@ namespace argon {
 		TextureAtlas(int texW = 0, int texH = 0) :m_texW(texW), m_texH(texH) {};
 		
 		void setTextureSize(int texW, int texH) { m_texW = texW; m_texH = texH; }
+		// text .atlas ("name x y w h" per line), or the rect table of a cooked
+		// .atex, which also sets the texture size from its header
 		bool loadFromFile(const std::string& path);
 
+		// register (or replace) a sprite by name; page indexes the atlas texture it lives on
+		SpriteId addSprite(const std::string& name, const Vec4& uv, std::uint32_t page = 0);
+
+		// Page 0 is the texture the atlas was loaded for (loadFromFile sprites),
+		// supplied by the renderable's material. Pages added here are owned by the
+		// atlas and numbered from 1 on, never reused.
+		std::uint32_t addPage(std::unique_ptr<Texture2D> texture);
+		const Texture2D* pageTexture(std::uint32_t page) const;
+		std::uint32_t pageCount() const { return (std::uint32_t)m_pages.size(); }
+
+		// sprites on a page with a material are drawn with it instead of the renderable's one
+		void setPageMaterial(std::uint32_t page, MaterialHandle material);
+		MaterialHandle pageMaterial(std::uint32_t page) const {
+			return page < m_pageMaterials.size() ? m_pageMaterials[page] : kInvalidMaterial;
+		}
+		// one material per owned page that has none yet: base with the page texture
+		void createPageMaterials(MaterialLibrary& materials, const Material2D& base);
+
 		SpriteId getId(const std::string& name) const;
 		Vec4 uvRect(SpriteId id) const;
+		std::uint32_t page(SpriteId id) const;
+		std::size_t spriteCount() const { return m_uvById.size() - 1; }
+		const AssetLoadStats& loadStats() const { return m_loadStats; }
 		
+	private:
+		bool loadFromText(const std::string& path);
+		bool loadFromCooked(const std::string& path);
+		void clearSprites();
+
 	private:
 		int m_texW = 0;
 		int m_texH = 0;
 		std::unordered_map<std::string, SpriteId> m_ids;
-		std::vector<Vec4> m_uvById;
+		std::vector<Vec4> m_uvById{ { 0.0f, 0.0f, 1.0f, 1.0f } }; // [0] = whole texture
+		std::vector<std::uint32_t> m_pageById{ 0 };
+		std::vector<std::unique_ptr<Texture2D>> m_pages = std::vector<std::unique_ptr<Texture2D>>(1); // [0] = null, see addPage
+		std::vector<MaterialHandle> m_pageMaterials;
+		AssetLoadStats m_loadStats;
 	};
 }
\ No newline at end of file
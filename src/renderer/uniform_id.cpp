@@ -0,0 +1,46 @@
+#include "renderer/uniform_id.h"
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace argon {
+
+	namespace {
+		struct UniformNames {
+			std::mutex mutex;
+			std::deque<std::string> names; // stable addresses for name()
+			std::unordered_map<std::string, std::uint32_t> ids;
+		};
+
+		UniformNames& uniformNames() {
+			static UniformNames s;
+			return s;
+		}
+	}
+
+	UniformId UniformId::of(const char* name) {
+		if (!name) return {};
+		UniformNames& u = uniformNames();
+		std::lock_guard<std::mutex> lock(u.mutex);
+		auto it = u.ids.find(name);
+		if (it != u.ids.end()) return { it->second };
+
+		const std::uint32_t index = (std::uint32_t)u.names.size();
+		u.names.emplace_back(name);
+		u.ids.emplace(u.names.back(), index);
+		return { index };
+	}
+
+	const char* UniformId::name(UniformId id) {
+		UniformNames& u = uniformNames();
+		std::lock_guard<std::mutex> lock(u.mutex);
+		return id.index < u.names.size() ? u.names[id.index].c_str() : "";
+	}
+
+	std::uint32_t UniformId::count() {
+		UniformNames& u = uniformNames();
+		std::lock_guard<std::mutex> lock(u.mutex);
+		return (std::uint32_t)u.names.size();
+	}
+}
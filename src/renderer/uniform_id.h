@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+
+namespace argon {
+
+	// Engine-wide handle for a uniform name. Names are interned once; every
+	// Shader reflects its active uniforms at link time into a table indexed by
+	// these handles, so setting a uniform through a UniformId is one array read
+	// with no hashing and no allocation. Resolve handles once and keep them,
+	// e.g. in a file-scope constant.
+	struct UniformId {
+		static constexpr std::uint32_t kInvalid = 0xFFFFFFFFu;
+		std::uint32_t index = kInvalid;
+
+		// interns name (hashes it; thread-safe). Array uniforms use the base name.
+		static UniformId of(const char* name);
+		// interned name of id, "" for invalid ids
+		static const char* name(UniformId id);
+		// number of names interned so far
+		static std::uint32_t count();
+
+		bool valid() const { return index != kInvalid; }
+		bool operator==(UniformId o) const { return index == o.index; }
+		bool operator!=(UniformId o) const { return index != o.index; }
+	};
+}
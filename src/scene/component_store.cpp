@@ -0,0 +1,58 @@
+#include "scene/component_store.h"
+
+namespace argon {
+
+	// stale ids stop matching; 0 is reserved, so the 8-bit counter wraps to 1
+	static std::uint8_t nextGeneration(std::uint8_t gen) {
+		return (std::uint8_t)(gen == 255 ? 1 : gen + 1);
+	}
+
+	EntityId ComponentStore::create() {
+		std::uint32_t index = 0;
+		if (!m_freeSlots.empty()) {
+			index = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		} else {
+			assert(m_generations.size() < kMaxEntities);
+			index = (std::uint32_t)m_generations.size();
+			m_generations.push_back(1);
+		}
+		m_alive++;
+		return makeEntityId(index, m_generations[index]);
+	}
+
+	void ComponentStore::destroy(EntityId id) {
+		if (!alive(id)) return;
+		for (auto& p : m_pools) {
+			if (p) p->remove(id);
+		}
+
+		const std::uint32_t index = entityIndex(id);
+		m_generations[index] = nextGeneration(m_generations[index]);
+		m_freeSlots.push_back(index);
+		m_alive--;
+	}
+
+	bool ComponentStore::alive(EntityId id) const {
+		const std::uint32_t index = entityIndex(id);
+		return id != kInvalidEntity && index < m_generations.size() && m_generations[index] == entityGeneration(id);
+	}
+
+	void ComponentStore::clear() {
+		for (auto& p : m_pools) {
+			if (p) p->clear();
+		}
+		// every slot is retired like destroy() would: ids held across the clear stay dead
+		m_freeSlots.clear();
+		m_freeSlots.reserve(m_generations.size());
+		for (std::size_t i = m_generations.size(); i-- > 0;) {
+			m_generations[i] = nextGeneration(m_generations[i]);
+			m_freeSlots.push_back((std::uint32_t)i); // popped from the back: low slots first
+		}
+		m_alive = 0;
+	}
+
+	void ComponentStore::reserve(std::size_t entities) {
+		m_generations.reserve(entities);
+	}
+}
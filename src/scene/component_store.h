@@ -0,0 +1,288 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace argon {
+
+	// low 24 bits: slot index, high 8 bits: generation (never 0, so 0 is never a live id)
+	using EntityId = std::uint32_t;
+	static constexpr EntityId kInvalidEntity = 0;
+	static constexpr std::uint32_t kEntityIndexBits = 24;
+	static constexpr std::uint32_t kEntityIndexMask = (1u << kEntityIndexBits) - 1;
+	static constexpr std::uint32_t kMaxEntities = kEntityIndexMask + 1;
+
+	inline std::uint32_t entityIndex(EntityId id) { return id & kEntityIndexMask; }
+	inline std::uint32_t entityGeneration(EntityId id) { return id >> kEntityIndexBits; }
+	inline EntityId makeEntityId(std::uint32_t index, std::uint32_t generation) {
+		return (generation << kEntityIndexBits) | (index & kEntityIndexMask);
+	}
+
+	// Sparse set: entity index -> dense slot. Dense arrays stay packed, removal
+	// swaps the last element into the hole, so iteration order is not stable.
+	class ComponentPoolBase {
+	public:
+		virtual ~ComponentPoolBase() = default;
+
+		virtual void remove(EntityId id) = 0;
+		virtual void clear() = 0;
+
+		bool has(EntityId id) const {
+			const std::uint32_t idx = entityIndex(id);
+			return idx < m_sparse.size() && m_sparse[idx] != kNone && m_entities[m_sparse[idx]] == id;
+		}
+
+		std::size_t size() const { return m_entities.size(); }
+		bool empty() const { return m_entities.empty(); }
+		const EntityId* entities() const { return m_entities.data(); }
+		// dense slot of id, valid while has(id)
+		std::uint32_t indexOf(EntityId id) const { return denseIndex(id); }
+
+	protected:
+		static constexpr std::uint32_t kNone = 0xFFFFFFFFu;
+
+		std::uint32_t denseIndex(EntityId id) const { return m_sparse[entityIndex(id)]; }
+
+		// returns the dense slot for a new entry
+		std::uint32_t insertSlot(EntityId id) {
+			const std::uint32_t idx = entityIndex(id);
+			if (idx >= m_sparse.size()) m_sparse.resize((std::size_t)idx + 1, kNone);
+			const std::uint32_t slot = (std::uint32_t)m_entities.size();
+			m_sparse[idx] = slot;
+			m_entities.push_back(id);
+			return slot;
+		}
+
+		// moves the last entry into slot, returns the slot the caller must pop
+		std::uint32_t eraseSlot(EntityId id) {
+			const std::uint32_t slot = denseIndex(id);
+			const std::uint32_t last = (std::uint32_t)m_entities.size() - 1;
+			const EntityId moved = m_entities[last];
+			m_entities[slot] = moved;
+			m_sparse[entityIndex(moved)] = slot;
+			m_sparse[entityIndex(id)] = kNone;
+			m_entities.pop_back();
+			return slot;
+		}
+
+		void clearSlots() {
+			m_sparse.clear();
+			m_entities.clear();
+		}
+
+	protected:
+		std::vector<std::uint32_t> m_sparse;
+		std::vector<EntityId> m_entities;
+	};
+
+	template<class T>
+	class ComponentPool final : public ComponentPoolBase {
+	public:
+		template<class... Args>
+		T& emplace(EntityId id, Args&&... args) {
+			if (has(id)) {
+				T& c = m_data[denseIndex(id)];
+				c = T{ std::forward<Args>(args)... };
+				return c;
+			}
+			insertSlot(id);
+			m_data.push_back(T{ std::forward<Args>(args)... });
+			return m_data.back();
+		}
+
+		void remove(EntityId id) override {
+			if (!has(id)) return;
+			const std::uint32_t slot = eraseSlot(id);
+			if (slot != m_data.size() - 1) m_data[slot] = std::move(m_data.back());
+			m_data.pop_back();
+		}
+
+		void clear() override {
+			clearSlots();
+			m_data.clear();
+		}
+
+		void reserve(std::size_t n) {
+			m_entities.reserve(n);
+			m_data.reserve(n);
+		}
+
+		T& get(EntityId id) { assert(has(id)); return m_data[denseIndex(id)]; }
+		const T& get(EntityId id) const { assert(has(id)); return m_data[denseIndex(id)]; }
+
+		T* tryGet(EntityId id) { return has(id) ? &m_data[denseIndex(id)] : nullptr; }
+		const T* tryGet(EntityId id) const { return has(id) ? &m_data[denseIndex(id)] : nullptr; }
+
+		// dense access, index i pairs with entities()[i]
+		T& at(std::size_t i) { return m_data[i]; }
+		const T& at(std::size_t i) const { return m_data[i]; }
+		T* data() { return m_data.data(); }
+		const T* data() const { return m_data.data(); }
+
+	private:
+		std::vector<T> m_data;
+	};
+
+	namespace detail {
+		inline std::uint32_t nextComponentTypeIndex() {
+			static std::atomic<std::uint32_t> next{ 0 };
+			return next++;
+		}
+
+		template<class T>
+		std::uint32_t componentTypeIndex() {
+			static const std::uint32_t index = nextComponentTypeIndex();
+			return index;
+		}
+	}
+
+	// Entities that own every component in Ts. Iteration walks the smallest pool
+	// densely and looks the others up through their sparse arrays; the callback
+	// only touches the component memory it actually reads. Do not add or remove
+	// components of the viewed types while iterating.
+	template<class... Ts>
+	class View {
+	public:
+		explicit View(ComponentPool<std::remove_const_t<Ts>>*... pools) : m_pools(pools...) {
+			const ComponentPoolBase* all[] = { pools... };
+			m_lead = all[0];
+			for (const ComponentPoolBase* p : all) {
+				if (p->size() < m_lead->size()) m_lead = p;
+			}
+		}
+
+		// upper bound on the number of entities each() visits
+		std::size_t sizeHint() const { return m_lead->size(); }
+
+		// fn(EntityId, Ts&...)
+		template<class Fn>
+		void each(Fn&& fn) const {
+			eachRange(0, m_lead->size(), fn);
+		}
+
+		// same as each() over dense slots [begin, end) of the lead pool, so disjoint
+		// ranges can run on different threads
+		template<class Fn>
+		void eachRange(std::size_t begin, std::size_t end, Fn&& fn) const {
+			const EntityId* ids = m_lead->entities();
+			end = std::min(end, m_lead->size());
+			for (std::size_t i = begin; i < end; ++i) {
+				const EntityId id = ids[i];
+				if (!hasAll(id, std::index_sequence_for<Ts...>{})) continue;
+				invoke(fn, id, i, std::index_sequence_for<Ts...>{});
+			}
+		}
+
+	private:
+		template<std::size_t... I>
+		bool hasAll(EntityId id, std::index_sequence<I...>) const {
+			return ((std::get<I>(m_pools) == m_lead || std::get<I>(m_pools)->has(id)) && ...);
+		}
+
+		template<class Fn, std::size_t... I>
+		void invoke(Fn& fn, EntityId id, std::size_t slot, std::index_sequence<I...>) const {
+			fn(id, fetch<Ts>(std::get<I>(m_pools), id, slot)...);
+		}
+
+		template<class T>
+		T& fetch(ComponentPool<std::remove_const_t<T>>* pool, EntityId id, std::size_t slot) const {
+			return pool == m_lead ? pool->at(slot) : pool->get(id);
+		}
+
+	private:
+		std::tuple<ComponentPool<std::remove_const_t<Ts>>*...> m_pools;
+		const ComponentPoolBase* m_lead = nullptr;
+	};
+
+	// Entity ids plus one packed pool per component type.
+	class ComponentStore {
+	public:
+		ComponentStore() = default;
+		ComponentStore(const ComponentStore&) = delete;
+		ComponentStore& operator=(const ComponentStore&) = delete;
+		ComponentStore(ComponentStore&&) noexcept = default;
+		ComponentStore& operator=(ComponentStore&&) noexcept = default;
+
+		EntityId create();
+		void destroy(EntityId id); // drops every component of id
+		bool alive(EntityId id) const;
+		std::size_t aliveCount() const { return m_alive; }
+
+		void clear(); // destroys every entity; ids held across it stay dead
+		void reserve(std::size_t entities);
+
+		template<class T, class... Args>
+		T& add(EntityId id, Args&&... args) {
+			assert(alive(id));
+			return pool<T>().emplace(id, std::forward<Args>(args)...);
+		}
+
+		template<class T>
+		void remove(EntityId id) {
+			if (ComponentPool<T>* p = findPool<T>()) p->remove(id);
+		}
+
+		template<class T>
+		bool has(EntityId id) const {
+			const ComponentPool<T>* p = findPool<T>();
+			return p && p->has(id);
+		}
+
+		template<class T> T& get(EntityId id) { return pool<T>().get(id); }
+		template<class T> const T& get(EntityId id) const { return pool<T>().get(id); }
+
+		template<class T> T* tryGet(EntityId id) {
+			ComponentPool<T>* p = findPool<T>();
+			return p ? p->tryGet(id) : nullptr;
+		}
+		template<class T> const T* tryGet(EntityId id) const {
+			const ComponentPool<T>* p = findPool<T>();
+			return p ? p->tryGet(id) : nullptr;
+		}
+
+		template<class T>
+		ComponentPool<T>& pool() {
+			const std::uint32_t type = detail::componentTypeIndex<T>();
+			if (type >= m_pools.size()) m_pools.resize((std::size_t)type + 1);
+			if (!m_pools[type]) m_pools[type] = std::make_unique<ComponentPool<T>>();
+			return static_cast<ComponentPool<T>&>(*m_pools[type]);
+		}
+
+		template<class T>
+		const ComponentPool<T>& pool() const {
+			static const ComponentPool<T> empty;
+			const ComponentPool<T>* p = findPool<T>();
+			return p ? *p : empty;
+		}
+
+		template<class... Ts>
+		View<Ts...> view() { return View<Ts...>(&pool<Ts>()...); }
+
+		// read-only view; pools the store has never seen behave as empty
+		template<class... Ts>
+		View<const Ts...> view() const {
+			return View<const Ts...>(const_cast<ComponentPool<Ts>*>(&pool<Ts>())...);
+		}
+
+	private:
+		template<class T>
+		ComponentPool<T>* findPool() const {
+			const std::uint32_t type = detail::componentTypeIndex<T>();
+			if (type >= m_pools.size() || !m_pools[type]) return nullptr;
+			return static_cast<ComponentPool<T>*>(m_pools[type].get());
+		}
+
+	private:
+		std::vector<std::uint8_t> m_generations; // per slot index, current generation
+		std::vector<std::uint32_t> m_freeSlots;
+		std::vector<std::unique_ptr<ComponentPoolBase>> m_pools; // by detail::componentTypeIndex
+		std::size_t m_alive = 0;
+	};
+}
@@ -1,11 +1,14 @@
 #pragma once
 #include <string>
 #include <cstdint>
+#include <cmath>
 #include "math/transform.h"
+#include "math/aabb_cull.h"
 #include "renderer/material2d.h"
 #include "renderer/mesh.h"
 #include "renderer/material_handle.h"
 #include "scene/animation2d.h"
+#include "scene/component_store.h"
 
 
 namespace argon {
@@ -15,18 +18,57 @@ namespace argon {
 		MaterialHandle material = kInvalidMaterial;
 		bool visible = true;
 		std::uint32_t layer = 0; //default world layer
+		std::uint16_t depth = 0; // draw order inside the layer, see RenderPacket2D::depth
 		Vec4 tint{ 1.0f,1.0f,1.0f,1.0f };
 		Vec4 uvRect{ 0.0f,0.0f,1.0f,1.0f }; // (u0,v0,u1,v1)
 		std::uint32_t spriteId = 0;
 	};
 
 
-	struct Entity {
+	// Cached world state of a Transform, kept by Scene for every spawned entity.
+	// Recomputed only after Scene::markMoved(); culling and packets read it
+	// instead of rebuilding the matrix every frame.
+	struct WorldTransform2D {
+		Affine2D matrix;
+		CullRect bounds;     // world AABB of the mesh bounds under matrix
+		bool dirty = false;  // queued for the next Scene::updateWorldTransforms
+	};
+
+	// bounds of the unit quad, for entities without a mesh
+	inline CullRect unitQuadBounds() { return { -0.5f, -0.5f, 0.5f, 0.5f }; }
+
+	inline void computeWorldTransform(const Transform& t, const CullRect& local, WorldTransform2D& out) {
+		const Affine2D& m = out.matrix = t.affine();
+		const float ax = m.a, ay = m.b;  // local x axis
+		const float bx = m.c, by = m.d;  // local y axis
+
+		// transformed center +- extents of the rotated local box
+		const float lcx = 0.5f * (local.minX + local.maxX);
+		const float lcy = 0.5f * (local.minY + local.maxY);
+		const float lhx = 0.5f * (local.maxX - local.minX);
+		const float lhy = 0.5f * (local.maxY - local.minY);
+		const float cx = t.x + ax * lcx + bx * lcy;
+		const float cy = t.y + ay * lcx + by * lcy;
+		const float ex = std::abs(ax) * lhx + std::abs(bx) * lhy;
+		const float ey = std::abs(ay) * lhx + std::abs(by) * lhy;
+		out.bounds = { cx - ex, cy - ey, cx + ex, cy + ey };
+	}
+
+	// tag: the entity follows the movement input
+	struct Controllable {};
+
+	// tag: background content that is baked into static GPU chunks by the
+	// render system (animated or non-instanced entities still draw dynamically)
+	struct StaticSprite {};
+
+	// Spawn description for Scene::spawn; the scene stores each part in its own
+	// component pool. The animator is only stored when it has a clip.
+	struct EntityDesc {
 		Animator2D animator;
-		bool animated = false;
 
 		Transform transform{};
 		Renderable2D renderable{};
 		bool controllable = false;
+		bool staticSprite = false; // also implied by Scene::setLayerStatic
 	};
 }
\ No newline at end of file
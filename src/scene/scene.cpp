@@ -1,6 +1,8 @@
 #include "scene/scene.h"
 #include "systems/camera_system.h"
 #include "systems/movement_system.h"
+#include <algorithm>
+#include <chrono>
 
 namespace argon {
 	Scene::Scene() 
@@ -11,20 +13,141 @@ namespace argon {
 	Scene::Scene(Scene&&) noexcept = default;
 	Scene& Scene::operator=(Scene&&) noexcept = default;
 
+	EntityId Scene::spawn(const EntityDesc& desc) {
+		const EntityId id = registry.create();
+		registry.add<Transform>(id, desc.transform);
+		registry.add<Renderable2D>(id, desc.renderable);
+		if (desc.animator.clip) registry.add<Animator2D>(id, desc.animator);
+		if (desc.controllable) registry.add<Controllable>(id);
+		if (desc.staticSprite || isLayerStatic(desc.renderable.layer)) {
+			registry.add<StaticSprite>(id);
+			m_staticRevision++;
+		}
+
+		WorldTransform2D& world = registry.add<WorldTransform2D>(id);
+		computeWorldTransform(desc.transform, localBoundsOf(id), world);
+		if (m_spatial) m_spatial->insert(id, world.bounds);
+		return id;
+	}
+
+	void Scene::destroy(EntityId id) {
+		if (m_spatial) m_spatial->remove(id);
+		if (registry.has<StaticSprite>(id)) m_staticRevision++;
+		registry.destroy(id);
+	}
+
+	void Scene::clear() {
+		registry.clear();
+		if (m_spatial) m_spatial->clear();
+		m_moved.clear();
+		m_staticRevision++;
+	}
+
+	bool Scene::isLayerStatic(std::uint32_t layer) const {
+		return std::find(m_staticLayers.begin(), m_staticLayers.end(), layer) != m_staticLayers.end();
+	}
+
+	void Scene::setLayerStatic(std::uint32_t layer, bool isStatic) {
+		if (isLayerStatic(layer) == isStatic) return;
+		if (isStatic) m_staticLayers.push_back(layer);
+		else m_staticLayers.erase(std::find(m_staticLayers.begin(), m_staticLayers.end(), layer));
+
+		// retag the entities already on the layer
+		std::vector<EntityId> ids;
+		registry.view<Renderable2D>().each([&](EntityId id, Renderable2D& r) {
+			if (r.layer == layer) ids.push_back(id);
+		});
+		for (EntityId id : ids) {
+			if (isStatic && !registry.has<StaticSprite>(id)) registry.add<StaticSprite>(id);
+			if (!isStatic && registry.has<StaticSprite>(id)) registry.remove<StaticSprite>(id);
+		}
+		m_staticRevision++;
+	}
+
+	void Scene::markStaticDirty(EntityId id) {
+		if (registry.has<StaticSprite>(id)) m_staticRevision++;
+	}
+
+	void Scene::enableSpatialIndex(float cellSize) {
+		if (m_spatial) {
+			m_spatial->setCellSize(cellSize);
+			return;
+		}
+		m_spatial = std::make_unique<SpatialHashGrid>(cellSize);
+		const ComponentPool<WorldTransform2D>& worlds = registry.pool<WorldTransform2D>();
+		const EntityId* ids = worlds.entities();
+		for (std::size_t i = 0; i < worlds.size(); ++i) {
+			// dirty entries are refreshed by the next updateWorldTransforms
+			m_spatial->insert(ids[i], worlds.at(i).bounds);
+		}
+	}
+
+	void Scene::disableSpatialIndex() {
+		m_spatial.reset();
+	}
+
+	CullRect Scene::localBoundsOf(EntityId id) const {
+		const Renderable2D* r = registry.tryGet<Renderable2D>(id);
+		return r && r->mesh ? r->mesh->localBounds() : unitQuadBounds();
+	}
+
+	void Scene::markMoved(EntityId id) {
+		if (registry.has<StaticSprite>(id)) m_staticRevision++;
+		WorldTransform2D* world = registry.tryGet<WorldTransform2D>(id);
+		if (!world || world->dirty) return;
+		world->dirty = true;
+		m_moved.push_back(id);
+	}
+
+	void Scene::updateWorldTransforms() {
+		using clock = std::chrono::steady_clock;
+		const auto t0 = clock::now();
+
+		ComponentPool<WorldTransform2D>& worlds = registry.pool<WorldTransform2D>();
+		const ComponentPool<Transform>& transforms = registry.pool<Transform>();
+
+		std::uint32_t recomputed = 0;
+		for (EntityId id : m_moved) {
+			// destroyed since it was marked
+			WorldTransform2D* world = worlds.tryGet(id);
+			const Transform* t = transforms.tryGet(id);
+			if (!world || !t) continue;
+
+			computeWorldTransform(*t, localBoundsOf(id), *world);
+			world->dirty = false;
+			if (m_spatial) m_spatial->update(id, world->bounds);
+			recomputed++;
+		}
+		m_moved.clear();
+
+		m_worldStats.recomputed = recomputed;
+		m_worldStats.ms = std::chrono::duration<float, std::milli>(clock::now() - t0).count();
+	}
+
+	void Scene::reserve(std::size_t entities) {
+		registry.reserve(entities);
+		registry.pool<Transform>().reserve(entities);
+		registry.pool<WorldTransform2D>().reserve(entities);
+		registry.pool<Renderable2D>().reserve(entities);
+	}
+
 	void Scene::update(float dt, FrameContext& ctx)	{
 		m_moveSys->update(*this, ctx.window, ctx.input, dt);
 		m_camSys->update(ctx.camCtl, dt);
 
-		for (auto& e : entities) {
-			if (!e.renderable.visible) continue;
+		// walks the animator pool only; the renderable is touched for animated entities.
+		// Static ones stay out of the bake (RenderSystem2D::rebakeStatic), so the
+		// new sprite needs no re-bake.
+		registry.view<Animator2D, Renderable2D>().each([dt](EntityId, Animator2D& anim, Renderable2D& r) {
+			if (!r.visible) return;
 
-			if (e.animator.clip) {
-				const std::uint32_t sid = e.animator.update(dt);
-				if (sid != 0) {
-					e.renderable.spriteId = sid;
-				}
+			const std::uint32_t sid = anim.update(dt);
+			if (sid != 0) {
+				r.spriteId = sid;
 			}
-		}
+		});
+
+		updateWorldTransforms();
 	}
 
 }
@@ -3,7 +3,9 @@
 #include <memory>
 
 #include "scene/entity.h"
+#include "scene/component_store.h"
 #include "scene/frame_context.h"
+#include "scene/spatial_grid.h"
 
 namespace argon{
 
@@ -21,12 +23,63 @@ namespace argon{
 		Scene(Scene&&) noexcept;
 		Scene& operator=(Scene&&) noexcept;
 
-		std::vector<Entity> entities;
+		// packed per-component storage: Transform, WorldTransform2D, Renderable2D,
+		// Animator2D, Controllable
+		ComponentStore registry;
+
+		EntityId spawn(const EntityDesc& desc);
+		void destroy(EntityId id);
+		void clear();
+		void reserve(std::size_t entities);
+		std::size_t entityCount() const { return registry.aliveCount(); }
 
 		void update(float dt, FrameContext& ctx);
 
+		// Every spawned entity carries a WorldTransform2D (matrix + world AABB).
+		// Code that changes a Transform, or the mesh of a Renderable2D, calls
+		// markMoved(); updateWorldTransforms() recomputes the marked entities in
+		// one pass and feeds the new bounds to the spatial index. update() runs
+		// it at its end.
+		void markMoved(EntityId id);
+		void updateWorldTransforms();
+
+		struct WorldStats {
+			std::uint32_t recomputed = 0; // last updateWorldTransforms()
+			float ms = 0.0f;
+		};
+		const WorldStats& worldStats() const { return m_worldStats; }
+
+		// Static content: entities tagged StaticSprite, or spawned on a static
+		// layer. staticRevision() tells the render system to re-bake; it is bumped
+		// by spawn(), destroy(), clear(), setLayerStatic(), and markMoved() or
+		// markStaticDirty() on a static entity. The baked chunks hold copies of
+		// the Renderable2D fields (mesh, material, spriteId, tint, uv, layer,
+		// depth, visible): code that edits any of them on a static entity calls
+		// markStaticDirty(), otherwise the edit shows after the next re-bake.
+		// Animated (Animator2D) static entities are never baked, they are drawn
+		// each frame with their current sprite and need no call.
+		void setLayerStatic(std::uint32_t layer, bool isStatic);
+		bool isLayerStatic(std::uint32_t layer) const;
+		void markStaticDirty(EntityId id);
+		std::uint64_t staticRevision() const { return m_staticRevision; }
+
+		// Optional spatial index over the world bounds, used by RenderSystem2D to
+		// cull large worlds.
+		void enableSpatialIndex(float cellSize);
+		void disableSpatialIndex();
+		const SpatialHashGrid* spatialIndex() const { return m_spatial.get(); }
+
 	private:
 		std::unique_ptr<MovementSystem> m_moveSys;
 		std::unique_ptr<CameraSystem>	m_camSys;
+
+		CullRect localBoundsOf(EntityId id) const;
+
+		std::unique_ptr<SpatialHashGrid> m_spatial;
+		std::vector<EntityId> m_moved;
+		WorldStats m_worldStats;
+
+		std::vector<std::uint32_t> m_staticLayers;
+		std::uint64_t m_staticRevision = 0;
 	};
-}
\ No newline at end of file
+}
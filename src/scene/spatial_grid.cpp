@@ -0,0 +1,211 @@
+#include "scene/spatial_grid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace argon {
+
+	static constexpr std::uint32_t kNoSlot = 0xFFFFFFFFu;
+
+	SpatialHashGrid::SpatialHashGrid(float cellSize) {
+		setCellSize(cellSize);
+	}
+
+	void SpatialHashGrid::setCellSize(float cellSize) {
+		m_cellSize = cellSize > 0.0f ? cellSize : 1.0f;
+		m_invCellSize = 1.0f / m_cellSize;
+
+		m_cells.clear();
+		m_oversized.clear();
+		for (Entry& e : m_entries) {
+			e.oversized = !storableRangeOf(e.bounds, e.cells);
+			link(e);
+		}
+	}
+
+	bool SpatialHashGrid::cellRangeOf(const CullRect& b, CellRange& out) const {
+		const float fx0 = std::floor(b.minX * m_invCellSize);
+		const float fy0 = std::floor(b.minY * m_invCellSize);
+		const float fx1 = std::floor(b.maxX * m_invCellSize);
+		const float fy1 = std::floor(b.maxY * m_invCellSize);
+
+		// also rejects NaN / inf bounds
+		const float lim = 1.0e9f;
+		if (!(fx0 >= -lim && fy0 >= -lim && fx1 <= lim && fy1 <= lim && fx0 <= fx1 && fy0 <= fy1)) return false;
+
+		out = { (std::int32_t)fx0, (std::int32_t)fy0, (std::int32_t)fx1, (std::int32_t)fy1 };
+		return true;
+	}
+
+	bool SpatialHashGrid::storableRangeOf(const CullRect& b, CellRange& out) const {
+		if (!cellRangeOf(b, out)) return false;
+		const std::int64_t cells = ((std::int64_t)out.x1 - out.x0 + 1) * ((std::int64_t)out.y1 - out.y0 + 1);
+		return cells <= (std::int64_t)kMaxCellsPerEntity;
+	}
+
+	void SpatialHashGrid::link(const Entry& e) {
+		const std::uint32_t idx = entityIndex(e.id);
+		if (e.oversized) {
+			m_oversized.push_back(idx);
+			return;
+		}
+		for (std::int32_t y = e.cells.y0; y <= e.cells.y1; ++y) {
+			for (std::int32_t x = e.cells.x0; x <= e.cells.x1; ++x) {
+				m_cells[cellKey(x, y)].push_back(idx);
+			}
+		}
+	}
+
+	void SpatialHashGrid::unlink(const Entry& e) {
+		const std::uint32_t idx = entityIndex(e.id);
+		auto eraseFrom = [idx](std::vector<std::uint32_t>& list) {
+			auto it = std::find(list.begin(), list.end(), idx);
+			if (it != list.end()) {
+				*it = list.back();
+				list.pop_back();
+			}
+		};
+
+		if (e.oversized) {
+			eraseFrom(m_oversized);
+			return;
+		}
+		for (std::int32_t y = e.cells.y0; y <= e.cells.y1; ++y) {
+			for (std::int32_t x = e.cells.x0; x <= e.cells.x1; ++x) {
+				auto it = m_cells.find(cellKey(x, y));
+				if (it == m_cells.end()) continue;
+				eraseFrom(it->second);
+				if (it->second.empty()) m_cells.erase(it);
+			}
+		}
+	}
+
+	void SpatialHashGrid::update(EntityId id, const CullRect& bounds) {
+		m_stats.updates++;
+		const std::uint32_t idx = entityIndex(id);
+		if (idx >= m_slotOf.size()) m_slotOf.resize((std::size_t)idx + 1, kNoSlot);
+
+		CellRange cells;
+		const bool oversized = !storableRangeOf(bounds, cells);
+
+		std::uint32_t slot = m_slotOf[idx];
+		if (slot != kNoSlot && m_entries[slot].id != id) {
+			// the slot index was recycled by a new entity, drop the stale entry
+			remove(m_entries[slot].id);
+			slot = kNoSlot;
+		}
+
+		if (slot == kNoSlot) {
+			slot = (std::uint32_t)m_entries.size();
+			m_slotOf[idx] = slot;
+			m_entries.push_back({ id, bounds, cells, oversized });
+			m_seen.push_back(0);
+			link(m_entries[slot]);
+			return;
+		}
+
+		Entry& e = m_entries[slot];
+		e.bounds = bounds;
+		if (e.oversized == oversized && (oversized || e.cells == cells)) return;
+
+		m_stats.cellMoves++;
+		unlink(e);
+		e.cells = cells;
+		e.oversized = oversized;
+		link(e);
+	}
+
+	void SpatialHashGrid::remove(EntityId id) {
+		const std::uint32_t idx = entityIndex(id);
+		if (idx >= m_slotOf.size()) return;
+		const std::uint32_t slot = m_slotOf[idx];
+		if (slot == kNoSlot || m_entries[slot].id != id) return;
+
+		unlink(m_entries[slot]);
+
+		const std::uint32_t last = (std::uint32_t)m_entries.size() - 1;
+		if (slot != last) {
+			m_entries[slot] = m_entries[last];
+			m_seen[slot] = m_seen[last];
+			m_slotOf[entityIndex(m_entries[slot].id)] = slot;
+		}
+		m_entries.pop_back();
+		m_seen.pop_back();
+		m_slotOf[idx] = kNoSlot;
+	}
+
+	bool SpatialHashGrid::contains(EntityId id) const {
+		const std::uint32_t idx = entityIndex(id);
+		return idx < m_slotOf.size() && m_slotOf[idx] != kNoSlot && m_entries[m_slotOf[idx]].id == id;
+	}
+
+	void SpatialHashGrid::clear() {
+		m_entries.clear();
+		m_slotOf.clear();
+		m_cells.clear();
+		m_oversized.clear();
+		m_seen.clear();
+	}
+
+	// calls fn(entry) once for every entry that may overlap rect
+	template<class Fn>
+	void SpatialHashGrid::visitCandidates(const CullRect& rect, Fn&& fn) const {
+		if (++m_queryStamp == 0) {
+			std::fill(m_seen.begin(), m_seen.end(), 0u);
+			m_queryStamp = 1;
+		}
+		const std::uint32_t stamp = m_queryStamp;
+		m_stats.lastQueryCells = 0;
+		m_stats.lastQueryTested = 0;
+
+		auto visitIndex = [&](std::uint32_t idx) {
+			const std::uint32_t slot = m_slotOf[idx];
+			if (m_seen[slot] == stamp) return;
+			m_seen[slot] = stamp;
+			m_stats.lastQueryTested++;
+			fn(m_entries[slot]);
+		};
+
+		for (std::uint32_t idx : m_oversized) visitIndex(idx);
+
+		CellRange range;
+		const bool bounded = cellRangeOf(rect, range);
+		const double rangeCells = bounded
+			? ((double)range.x1 - range.x0 + 1.0) * ((double)range.y1 - range.y0 + 1.0)
+			: 0.0;
+
+		if (bounded && rangeCells <= (double)m_cells.size()) {
+			for (std::int32_t y = range.y0; y <= range.y1; ++y) {
+				for (std::int32_t x = range.x0; x <= range.x1; ++x) {
+					auto it = m_cells.find(cellKey(x, y));
+					if (it == m_cells.end()) continue;
+					m_stats.lastQueryCells++;
+					for (std::uint32_t idx : it->second) visitIndex(idx);
+				}
+			}
+			return;
+		}
+
+		// the rect covers more cells than are occupied (or is unbounded): walk the occupied ones
+		for (const auto& cell : m_cells) {
+			m_stats.lastQueryCells++;
+			for (std::uint32_t idx : cell.second) visitIndex(idx);
+		}
+	}
+
+	void SpatialHashGrid::queryRect(const CullRect& rect, std::vector<EntityId>& out) const {
+		visitCandidates(rect, [&](const Entry& e) {
+			if (overlaps(e.bounds, rect)) out.push_back(e.id);
+		});
+	}
+
+	void SpatialHashGrid::queryPoint(float x, float y, std::vector<EntityId>& out) const {
+		const CullRect p{ x, y, x, y };
+		queryRect(p, out);
+	}
+
+	void SpatialHashGrid::queryOriented(const OrientedRect& rect, std::vector<EntityId>& out) const {
+		visitCandidates(boundsOf(rect), [&](const Entry& e) {
+			if (overlaps(rect, e.bounds)) out.push_back(e.id);
+		});
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "math/aabb_cull.h"
+#include "scene/component_store.h"
+
+namespace argon {
+
+	// Uniform hash grid over entity AABBs, maintained incrementally: update()
+	// only touches the cell lists when an entity crosses a cell boundary.
+	// Entities spanning more than kMaxCellsPerEntity cells live in a side list
+	// that every query tests directly.
+	//
+	// Queries are const but share a dedup stamp, so run them on one thread.
+	class SpatialHashGrid {
+	public:
+		static constexpr std::uint32_t kMaxCellsPerEntity = 64;
+
+		struct Stats {
+			std::uint32_t updates = 0;     // update()/insert() calls
+			std::uint32_t cellMoves = 0;   // of those, entities that changed cells
+			std::uint32_t lastQueryCells = 0;
+			std::uint32_t lastQueryTested = 0;
+			void reset() { *this = Stats{}; }
+		};
+
+		explicit SpatialHashGrid(float cellSize = 1.0f);
+
+		// rebuilds every cell list
+		void setCellSize(float cellSize);
+		float cellSize() const { return m_cellSize; }
+
+		// insert or move; bounds are world space
+		void update(EntityId id, const CullRect& bounds);
+		void insert(EntityId id, const CullRect& bounds) { update(id, bounds); }
+		void remove(EntityId id);
+		bool contains(EntityId id) const;
+		void clear();
+
+		std::size_t size() const { return m_entries.size(); }
+		std::size_t cellCount() const { return m_cells.size(); }
+
+		// Append every entity whose bounds overlap, each once, in no particular order.
+		void queryRect(const CullRect& rect, std::vector<EntityId>& out) const;
+		void queryPoint(float x, float y, std::vector<EntityId>& out) const;
+		// exact test against the rotated rect, e.g. Camera2D::viewRect
+		void queryOriented(const OrientedRect& rect, std::vector<EntityId>& out) const;
+
+		const Stats& stats() const { return m_stats; }
+		void resetStats() { m_stats.reset(); }
+
+	private:
+		struct CellRange {
+			std::int32_t x0 = 0, y0 = 0, x1 = -1, y1 = -1;
+			bool operator==(const CellRange& o) const { return x0 == o.x0 && y0 == o.y0 && x1 == o.x1 && y1 == o.y1; }
+		};
+
+		struct Entry {
+			EntityId id = kInvalidEntity;
+			CullRect bounds;
+			CellRange cells;
+			bool oversized = false;
+		};
+
+		struct CellHash {
+			std::size_t operator()(std::uint64_t k) const {
+				k ^= k >> 33; k *= 0xff51afd7ed558ccdull; k ^= k >> 33;
+				return (std::size_t)k;
+			}
+		};
+
+		static std::uint64_t cellKey(std::int32_t x, std::int32_t y) {
+			return ((std::uint64_t)(std::uint32_t)x << 32) | (std::uint32_t)y;
+		}
+
+		// false for non-finite or inverted bounds
+		bool cellRangeOf(const CullRect& b, CellRange& out) const;
+		// additionally false when the range spans more than kMaxCellsPerEntity cells
+		bool storableRangeOf(const CullRect& b, CellRange& out) const;
+		void link(const Entry& e);
+		void unlink(const Entry& e);
+
+		template<class Fn>
+		void visitCandidates(const CullRect& rect, Fn&& fn) const;
+
+	private:
+		float m_cellSize = 1.0f;
+		float m_invCellSize = 1.0f;
+
+		std::vector<Entry> m_entries;
+		std::vector<std::uint32_t> m_slotOf; // entity index -> m_entries slot
+		std::unordered_map<std::uint64_t, std::vector<std::uint32_t>, CellHash> m_cells; // -> entity indices
+		std::vector<std::uint32_t> m_oversized; // entity indices
+
+		mutable std::vector<std::uint32_t> m_seen; // per entry slot, query stamp
+		mutable std::uint32_t m_queryStamp = 0;
+		mutable Stats m_stats;
+	};
+}
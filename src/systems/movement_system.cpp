@@ -11,22 +11,22 @@ namespace argon {
 									   const InputMap& input,
 									   float dt) const {
 
-		for (auto& e : scene.entities) {
-			if (!e.controllable) continue;
+		float dx = 0.0f, dy = 0.0f;
+		if (input.down(win, Action::MoveLeft))	dx -= 1.0f;
+		if (input.down(win, Action::MoveRight)) dx += 1.0f;
+		if (input.down(win, Action::MoveUp))	dy += 1.0f;
+		if (input.down(win, Action::MoveDown))	dy -= 1.0f;
 
-			float dx = 0.0f, dy = 0.0f;
-			if (input.down(win, Action::MoveLeft))	dx -= 1.0f;
-			if (input.down(win, Action::MoveRight)) dx += 1.0f;
-			if (input.down(win, Action::MoveUp))	dy += 1.0f;
-			if (input.down(win, Action::MoveDown))	dy -= 1.0f;
+		if (dx == 0.0f && dy == 0.0f) return;
 
-			if (dx != 0.0f || dy != 0.0f) {
-				float len = std::sqrt(dx * dx + dy * dy);
-				dx /= len; dy /= len;
+		float len = std::sqrt(dx * dx + dy * dy);
+		dx /= len; dy /= len;
 
-				e.transform.x += dx * speed * dt;
-				e.transform.y += dy * speed * dt;
-			}
-		}
+		// the Controllable pool is tiny, it leads the view
+		scene.registry.view<Controllable, Transform>().each([&](EntityId id, Controllable&, Transform& t) {
+			t.x += dx * speed * dt;
+			t.y += dy * speed * dt;
+			scene.markMoved(id);
+		});
 	}
 }
\ No newline at end of file
@@ -4,95 +4,329 @@
 #include "renderer/render_packet2d.h"
 #include "renderer/render_frame2d.h"
 #include "gfx/camera2d.h"
+#include "core/thread_pool.h"
+#include "scene/spatial_grid.h"
+#include "renderer/material_library.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
 #include <cmath>
+#include <limits>
 #include <vector>
 
 namespace argon {
 
-	static inline bool aabbIntersects(
-		float minAx, float minAy, float maxAx, float maxAy,
-		float minBx, float minBy, float maxBx, float maxBy)
-	{
-		return !(maxAx < minBx ||
-				 maxBx < minAx ||
-				 maxAy < minBy ||
-				 maxBy < minAy);
+	// entities per cull chunk; smaller chunks lose more to scheduling than they gain
+	static constexpr std::size_t kParallelCullMinChunk = 8192;
+	// minX that fails every overlap test
+	static constexpr float kNeverVisible = std::numeric_limits<float>::infinity();
+
+	void RenderSystem2D::bindFrameMemory() {
+		if (!m_arena || m_arena->frame() == m_arenaFrame) return;
+		m_arenaFrame = m_arena->frame();
+		rebindFrameVector(m_minX, m_arena);
+		rebindFrameVector(m_minY, m_arena);
+		rebindFrameVector(m_maxX, m_arena);
+		rebindFrameVector(m_maxY, m_arena);
+		rebindFrameVector(m_visibleSlots, m_arena);
+		for (FrameVector<RenderPacket2D>& chunk : m_chunkPackets) rebindFrameVector(chunk, m_arena);
+	}
+
+	void RenderSystem2D::prepareCull(const Scene& scene) {
+		const std::size_t n = scene.registry.pool<WorldTransform2D>().size();
+		m_minX.resize(n);
+		m_minY.resize(n);
+		m_maxX.resize(n);
+		m_maxY.resize(n);
+		m_visibleSlots.resize(n);
 	}
 
 	template<class Fn>
-	void RenderSystem2D::forEachVisible(const Scene& scene,
-										const Renderer& renderer,
-										const Camera2D& cam,
-										float aspect,
-										Fn&& fn) const
+	void RenderSystem2D::emitPackets(const Scene& scene, const Renderer& renderer,
+									 const std::uint32_t* slots, std::size_t count, Fn&& fn)
 	{
-		// camera view bounds in world space
-		const float halfH = cam.size / cam.zoom;
-		const float halfW = cam.size * aspect / cam.zoom;
-
-		const float vx0 = cam.x - halfW;
-		const float vx1 = cam.x + halfW;
-		const float vy0 = cam.y - halfH;
-		const float vy1 = cam.y + halfH;
+		const ComponentPool<WorldTransform2D>& worlds = scene.registry.pool<WorldTransform2D>();
+		const ComponentPool<Transform>& transforms = scene.registry.pool<Transform>();
+		const ComponentPool<Renderable2D>& renderables = scene.registry.pool<Renderable2D>();
+		const EntityId* ids = worlds.entities();
+		const TextureAtlas* atlas = renderer.atlas();
 
-		for (const auto& e : scene.entities) {
-			if (!e.renderable.visible) continue;
-			if (!e.renderable.mesh) continue;
+		for (std::size_t k = 0; k < count; ++k) {
+			const std::uint32_t slot = slots[k];
+			const WorldTransform2D& w = worlds.at(slot);
+			const Renderable2D& r = renderables.get(ids[slot]);
 
-			//entity  AABB ignore rotation for now
-			const float hw = 0.5f * std::abs(e.transform.sx);
-			const float hh = 0.5f * std::abs(e.transform.sy);
-
-			const float ex0 = e.transform.x - hw;
-			const float ex1 = e.transform.x + hw;
-			const float ey0 = e.transform.y - hh;
-			const float ey1 = e.transform.y + hh;
-
-			if (!aabbIntersects(ex0, ey0, ex1, ey1, vx0, vy0, vx1, vy1))
-				continue;
+			if (!r.visible) continue;
+			if (!r.mesh) continue;
 
 			RenderPacket2D pkt;
 			pkt.visible = true;
-			pkt.mesh = e.renderable.mesh;
-			pkt.model = e.transform.matrix();
-			pkt.material = e.renderable.material;
-			pkt.layer = e.renderable.layer;
-			pkt.tint = e.renderable.tint;
-
-			if (e.renderable.spriteId != 0) {
-				if (const TextureAtlas* atlas = renderer.atlas()) {
-					pkt.uvRect = atlas->uvRect(e.renderable.spriteId);
+			pkt.mesh = r.mesh;
+			// instanced sprites in the Trs layout take the raw fields, the shader expands them
+			pkt.gpuTransform = renderer.expandsTransformOnGpu(r.mesh);
+			if (pkt.gpuTransform) pkt.trs = transforms.get(ids[slot]);
+			else pkt.model = w.matrix;
+			pkt.material = r.material;
+			pkt.layer = r.layer;
+			pkt.depth = r.depth;
+			pkt.tint = r.tint;
+
+			if (r.spriteId != 0) {
+				if (atlas) {
+					pkt.uvRect = atlas->uvRect(r.spriteId);
+					// packed pages carry their own texture, hence their own material
+					const MaterialHandle pageMat = atlas->pageMaterial(atlas->page(r.spriteId));
+					if (pageMat != kInvalidMaterial) pkt.material = pageMat;
 				}
 			} else {
-				pkt.uvRect = e.renderable.uvRect;
+				pkt.uvRect = r.uvRect;
 			}
 
 			fn(pkt);
 		}
 	}
 
+	// Only reads scene data and writes slots [begin, end) of the cull arrays,
+	// safe to run on several disjoint ranges at once.
+	template<class Fn>
+	void RenderSystem2D::cullSlots(const Scene& scene, const Renderer& renderer, const CullRect& view,
+								   std::size_t begin, std::size_t end, Fn&& fn)
+	{
+		const ComponentPool<WorldTransform2D>& worlds = scene.registry.pool<WorldTransform2D>();
+		const ComponentPool<Renderable2D>& renderables = scene.registry.pool<Renderable2D>();
+		const ComponentPool<StaticSprite>& statics = scene.registry.pool<StaticSprite>();
+		const EntityId* ids = worlds.entities();
+
+		// stage 1: cached world bounds into the packed arrays; no renderable or
+		// static (drawn by submitStatic) => empty box
+		for (std::size_t i = begin; i < end; ++i) {
+			const CullRect& b = worlds.at(i).bounds;
+			const bool drawable = renderables.has(ids[i]) && !statics.has(ids[i]);
+			m_minX[i] = drawable ? b.minX : kNeverVisible;
+			m_minY[i] = b.minY;
+			m_maxX[i] = b.maxX;
+			m_maxY[i] = b.maxY;
+		}
+
+		// stage 2: 4/8 boxes per compare, compact list of visible slots
+		const AabbArrays boxes{ m_minX.data(), m_minY.data(), m_maxX.data(), m_maxY.data() };
+		std::uint32_t* visible = m_visibleSlots.data() + begin;
+		const std::size_t visibleCount = cullAabbs(boxes, begin, end, view, visible);
+
+		// stage 3: packets for the survivors
+		emitPackets(scene, renderer, m_visibleSlots.data() + begin, visibleCount, fn);
+	}
+
+	std::size_t RenderSystem2D::queryIndex(const Scene& scene, const SpatialHashGrid& grid, const OrientedRect& view) {
+		const ComponentPool<WorldTransform2D>& worlds = scene.registry.pool<WorldTransform2D>();
+		const ComponentPool<Renderable2D>& renderables = scene.registry.pool<Renderable2D>();
+		const ComponentPool<StaticSprite>& statics = scene.registry.pool<StaticSprite>();
+
+		m_candidates.clear();
+		grid.queryOriented(view, m_candidates);
+		m_stats.tested = grid.stats().lastQueryTested;
+
+		m_visibleSlots.clear();
+		for (EntityId id : m_candidates) {
+			if (!worlds.has(id) || !renderables.has(id) || statics.has(id)) continue;
+			m_visibleSlots.push_back(worlds.indexOf(id));
+		}
+		// slot order, the packets come out as on the linear path
+		std::sort(m_visibleSlots.begin(), m_visibleSlots.end());
+		return m_visibleSlots.size();
+	}
+
+	template<class Fn>
+	bool RenderSystem2D::cull(const Scene& scene,
+							  const Renderer& renderer,
+							  const Camera2D& cam,
+							  float aspect,
+							  Fn&& fn)
+	{
+		bindFrameMemory();
+		if (const SpatialHashGrid* grid = scene.spatialIndex()) {
+			m_stats.indexed = true;
+			const std::size_t count = queryIndex(scene, *grid, cam.viewRect(aspect));
+			const std::size_t chunks = m_jobs ? m_jobs->chunkCount(count, kParallelCullMinChunk) : 1;
+			if (chunks <= 1) {
+				emitPackets(scene, renderer, m_visibleSlots.data(), count, fn);
+				return false;
+			}
+
+			if (m_chunkPackets.size() < chunks) m_chunkPackets.resize(chunks, FrameVector<RenderPacket2D>(FrameAllocator<RenderPacket2D>(m_arena)));
+			m_jobs->parallelFor(count, kParallelCullMinChunk, [&](std::size_t begin, std::size_t end, std::size_t c) {
+				FrameVector<RenderPacket2D>& out = m_chunkPackets[c];
+				out.clear();
+				emitPackets(scene, renderer, m_visibleSlots.data() + begin, end - begin, [&](const RenderPacket2D& pkt) {
+					out.push_back(pkt);
+				});
+			});
+			m_stats.chunks = (std::uint32_t)chunks;
+			return true;
+		}
+
+		const std::size_t n = scene.registry.pool<WorldTransform2D>().size();
+		m_stats.tested = (std::uint32_t)scene.registry.pool<Renderable2D>().size();
+		prepareCull(scene);
+		const CullRect view = cam.viewBounds(aspect);
+
+		const std::size_t chunks = m_jobs ? m_jobs->chunkCount(n, kParallelCullMinChunk) : 1;
+		if (chunks <= 1) {
+			cullSlots(scene, renderer, view, 0, n, fn);
+			return false;
+		}
+
+		if (m_chunkPackets.size() < chunks) m_chunkPackets.resize(chunks, FrameVector<RenderPacket2D>(FrameAllocator<RenderPacket2D>(m_arena)));
+		m_jobs->parallelFor(n, kParallelCullMinChunk, [&](std::size_t begin, std::size_t end, std::size_t c) {
+			FrameVector<RenderPacket2D>& out = m_chunkPackets[c];
+			out.clear();
+			cullSlots(scene, renderer, view, begin, end, [&](const RenderPacket2D& pkt) {
+				out.push_back(pkt);
+			});
+		});
+		m_stats.chunks = (std::uint32_t)chunks;
+		return true;
+	}
+
+	void RenderSystem2D::rebakeStatic(const Scene& scene, Renderer& renderer) {
+		using clock = std::chrono::steady_clock;
+		const auto t0 = clock::now();
+
+		const ComponentPool<StaticSprite>& statics = scene.registry.pool<StaticSprite>();
+		const ComponentPool<WorldTransform2D>& worlds = scene.registry.pool<WorldTransform2D>();
+		const ComponentPool<Renderable2D>& renderables = scene.registry.pool<Renderable2D>();
+		const ComponentPool<Animator2D>& animators = scene.registry.pool<Animator2D>();
+
+		// animated sprites would need a re-bake every frame: keep them dynamic
+		m_staticLoose.clear();
+		m_staticSlots.clear();
+		const EntityId* ids = statics.entities();
+		for (std::size_t i = 0; i < statics.size(); ++i) {
+			const EntityId id = ids[i];
+			const Renderable2D* r = renderables.tryGet(id);
+			if (!r || !worlds.has(id) || !r->visible || !r->mesh) continue;
+			if (animators.has(id)) m_staticLoose.push_back(id);
+			else m_staticSlots.push_back(worlds.indexOf(id));
+		}
+
+		// every slot passed the visible/mesh checks, so packet k is slot k
+		m_staticPackets.clear();
+		emitPackets(scene, renderer, m_staticSlots.data(), m_staticSlots.size(), [&](const RenderPacket2D& pkt) {
+			m_staticPackets.push_back(pkt);
+		});
+
+		std::size_t baked = 0;
+		const EntityId* worldIds = worlds.entities();
+		for (std::size_t k = 0; k < m_staticPackets.size(); ++k) {
+			if (renderer.canBakeStatic(m_staticPackets[k])) m_staticPackets[baked++] = m_staticPackets[k];
+			else m_staticLoose.push_back(worldIds[m_staticSlots[k]]);
+		}
+		renderer.bakeStatic(m_staticPackets.data(), baked);
+
+		m_staticRevision = scene.staticRevision();
+		m_staticGeneration = renderer.staticStats().generation;
+		m_staticStats.bakes++;
+		m_staticStats.baked = (std::uint32_t)baked;
+		m_staticStats.loose = (std::uint32_t)m_staticLoose.size();
+		m_staticStats.bakeMs = std::chrono::duration<float, std::milli>(clock::now() - t0).count();
+	}
+
+	void RenderSystem2D::submitStatic(const Scene& scene,
+									  Renderer& renderer,
+									  const Camera2D& cam,
+									  float aspect)
+	{
+		if (scene.staticRevision() != m_staticRevision ||
+			renderer.staticStats().generation != m_staticGeneration) {
+			rebakeStatic(scene, renderer);
+		}
+
+		const CullRect view = cam.viewBounds(aspect);
+		renderer.submitStatic(view);
+
+		if (m_staticLoose.empty()) return;
+		const ComponentPool<WorldTransform2D>& worlds = scene.registry.pool<WorldTransform2D>();
+		m_staticSlots.clear();
+		for (EntityId id : m_staticLoose) {
+			const WorldTransform2D* w = worlds.tryGet(id);
+			if (w && overlaps(w->bounds, view)) m_staticSlots.push_back(worlds.indexOf(id));
+		}
+		emitPackets(scene, renderer, m_staticSlots.data(), m_staticSlots.size(), [&](const RenderPacket2D& pkt) {
+			renderer.submit(pkt);
+		});
+	}
+
 	void RenderSystem2D::buildPackets(const Scene& scene,
 									  Renderer& renderer,
 									  const Camera2D& cam,
 									  float aspect,
-									  RenderFrame2D& out) const
+									  RenderFrame2D& out)
 	{
+		using clock = std::chrono::steady_clock;
+		const auto t0 = clock::now();
+		m_stats = {};
+		m_stats.kernel = bestCullKernel();
+
+		assert(out.matlib && "RenderFrame2D.matlib is null");
+		const MaterialLibrary& matlib = *out.matlib;
+
 		out.clearPackets();
-		out.packets.reserve(scene.entities.size() + 16);
+		out.packets.reserve(scene.entityCount() + 16);
 
-		forEachVisible(scene, renderer, cam, aspect, [&](const RenderPacket2D& pkt) {
-			out.packets.push_back(pkt);
+		const bool parallel = cull(scene, renderer, cam, aspect, [&](const RenderPacket2D& pkt) {
+			out.packets.push(pkt, renderer.sortKey(pkt, matlib));
 		});
+
+		if (parallel) {
+			// chunk c lands right after chunks 0..c-1: same order as the serial walk
+			FrameVector<std::size_t> offsets(m_stats.chunks + 1, 0, FrameAllocator<std::size_t>(m_arena));
+			for (std::uint32_t c = 0; c < m_stats.chunks; ++c) {
+				offsets[c + 1] = offsets[c] + m_chunkPackets[c].size();
+			}
+			out.packets.resize(offsets.back());
+			RenderPacket2D* packets = out.packets.packets();
+			std::uint64_t* keys = out.packets.keys();
+
+			// keys only read the material library, so they are computed per chunk too
+			m_jobs->parallelFor(m_stats.chunks, 1, [&](std::size_t begin, std::size_t end, std::size_t) {
+				for (std::size_t c = begin; c < end; ++c) {
+					const FrameVector<RenderPacket2D>& src = m_chunkPackets[c];
+					std::copy(src.begin(), src.end(), packets + offsets[c]);
+					for (std::size_t i = 0; i < src.size(); ++i) {
+						keys[offsets[c] + i] = renderer.sortKey(src[i], matlib);
+					}
+				}
+			});
+		}
+
+		m_stats.visible = (std::uint32_t)out.packets.size();
+		m_stats.cullMs = std::chrono::duration<float, std::milli>(clock::now() - t0).count();
 	}
 
 	void RenderSystem2D::submitVisible(const Scene& scene,
 									   Renderer& renderer,
 									   const Camera2D& cam,
-									   float aspect) const
+									   float aspect)
 	{
-		forEachVisible(scene, renderer, cam, aspect, [&](const RenderPacket2D& pkt) {
+		using clock = std::chrono::steady_clock;
+		const auto t0 = clock::now();
+		m_stats = {};
+		m_stats.kernel = bestCullKernel();
+
+		const bool parallel = cull(scene, renderer, cam, aspect, [&](const RenderPacket2D& pkt) {
 			renderer.submit(pkt);
+			m_stats.visible++;
 		});
+
+		if (parallel) {
+			// the renderer queue is single threaded: append the buffers in chunk order
+			for (std::uint32_t c = 0; c < m_stats.chunks; ++c) {
+				renderer.submit(m_chunkPackets[c].data(), m_chunkPackets[c].size());
+				m_stats.visible += (std::uint32_t)m_chunkPackets[c].size();
+			}
+		}
+
+		m_stats.cullMs = std::chrono::duration<float, std::milli>(clock::now() - t0).count();
 	}
 
 
@@ -1,26 +1,115 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
+#include <vector>
+#include "core/frame_arena.h"
+#include "renderer/render_packet2d.h"
+#include "math/aabb_cull.h"
+#include "scene/component_store.h"
 
 namespace argon {
 	
 	class Scene;
 	class Renderer;
 	class Camera2D;
+	class ThreadPool;
+	class TextureAtlas;
+	class SpatialHashGrid;
 	struct RenderFrame2D;
-	struct RenderPacket2D;
 
 	class RenderSystem2D {
 	public:
+		struct Stats {
+			float cullMs = 0.0f;         // cull + packet build (+ merge), last call
+			std::uint32_t tested = 0;    // entities tested against the view
+			std::uint32_t visible = 0;
+			std::uint32_t chunks = 1;    // 1 = serial
+			CullKernel kernel = CullKernel::Scalar;
+			bool indexed = false;        // candidates came from the scene's spatial index
+		};
+
+		struct StaticStats {
+			float bakeMs = 0.0f;         // last re-bake, packet build + upload
+			std::uint32_t bakes = 0;
+			std::uint32_t baked = 0;     // StaticSprite entities in GPU chunks
+			std::uint32_t loose = 0;     // StaticSprite entities that cannot be baked
+		};
+
+		// Entities tagged StaticSprite never reach submitVisible/buildPackets.
+		// submitStatic re-bakes them when the scene's staticRevision changed
+		// (see Scene::markStaticDirty for renderable edits),
+		// queues the visible baked chunks, and submits the few that cannot be
+		// baked (animated, or not drawn by the instanced sprite path) directly.
+		// Needs an open pass; WorldPass2D calls it in both frame modes.
+		void submitStatic(const Scene& scene, Renderer& renderer,
+						  const Camera2D& cam, float aspect);
+
 		void submitVisible(const Scene& scene, Renderer& renderer,
-						   const Camera2D& cam, float aspect) const;
+						   const Camera2D& cam, float aspect);
 
 		void buildPackets(const Scene& scene, Renderer& renderer, const Camera2D& cam,
-						  float aspect, RenderFrame2D& out) const;
+						  float aspect, RenderFrame2D& out);
+
+		// The view is the camera rect, rotation included. When the scene has a
+		// spatial index only the entities it returns are tested; otherwise every
+		// WorldTransform2D slot goes through the SIMD kernel.
+		//
+		// optional: scenes large enough to split are culled on this pool. Every
+		// chunk writes its own packet buffer; buffers are merged in chunk order, so
+		// the output is identical to the serial walk.
+		void setThreadPool(ThreadPool* pool) { m_jobs = pool; }
+		// optional: cull arrays and chunk packet buffers come from this arena
+		void setFrameArena(FrameArena* arena) { m_arena = arena; }
+		const Stats& stats() const { return m_stats; }
+		const StaticStats& staticStats() const { return m_staticStats; }
 
 	private:
+		void rebakeStatic(const Scene& scene, Renderer& renderer);
+
+		// Culling runs in stages over dense slots of the WorldTransform2D pool:
+		// gather bounds into the packed arrays, run the SIMD cull kernel into a
+		// visible slot list, then build packets for the survivors only.
+		void prepareCull(const Scene& scene);
+		// once per arena frame: moves the per-cull buffers onto it
+		void bindFrameMemory();
+
+		template<class Fn>
+		void cullSlots(const Scene& scene, const Renderer& renderer, const CullRect& view,
+					   std::size_t begin, std::size_t end, Fn&& fn);
+
+		// packets for the given WorldTransform2D slots, in slot order
 		template<class Fn>
-		void forEachVisible(const Scene& scene, const Renderer& renderer,
-			const Camera2D& cam, float aspect, Fn&& fn) const;
+		void emitPackets(const Scene& scene, const Renderer& renderer,
+						 const std::uint32_t* slots, std::size_t count, Fn&& fn);
+
+		// spatial index query -> ascending WorldTransform2D slots in m_visibleSlots
+		std::size_t queryIndex(const Scene& scene, const SpatialHashGrid& grid, const OrientedRect& view);
+
+		// Runs the cull. Returns true when it went parallel and the packets are in
+		// m_chunkPackets[0..m_stats.chunks); otherwise every packet was passed to fn.
+		template<class Fn>
+		bool cull(const Scene& scene, const Renderer& renderer,
+				  const Camera2D& cam, float aspect, Fn&& fn);
+
+	private:
+		ThreadPool* m_jobs = nullptr;
+		FrameArena* m_arena = nullptr;
+		std::uint64_t m_arenaFrame = ~0ull;
+		std::vector<FrameVector<RenderPacket2D>> m_chunkPackets;
+		Stats m_stats;
+
+		// per WorldTransform2D slot, rebuilt every cull
+		FrameVector<float> m_minX, m_minY, m_maxX, m_maxY;
+		FrameVector<std::uint32_t> m_visibleSlots; // chunk [begin,end) writes from begin on
+		std::vector<EntityId> m_candidates;        // spatial index query result
+
+		// static content
+		StaticStats m_staticStats;
+		std::uint64_t m_staticRevision = ~0ull;     // scene revision of the last bake
+		std::uint32_t m_staticGeneration = ~0u;     // renderer cache generation after it
+		std::vector<EntityId> m_staticLoose;
+		std::vector<RenderPacket2D> m_staticPackets;
+		std::vector<std::uint32_t> m_staticSlots;
 	};
 
-}
\ No newline at end of file
+}
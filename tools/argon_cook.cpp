@@ -0,0 +1,206 @@
+// argon_cook: offline texture cooker.
+//
+//   argon_cook <image> <out.atex> [--atlas <file.atlas>] [--mips <n>]
+//
+// Decodes the image once, stores RGBA8 rows bottom to top (what Texture2D
+// uploads), builds a box-filtered mip chain and embeds the atlas rect table,
+// so the runtime maps the result and uploads without decoding or parsing.
+// --mips 0 writes the full chain, --mips 1 only the base level. The default
+// is the full chain for plain textures and the base level with --atlas: the
+// box filter does not respect rect borders, so on an atlas without gutters
+// smaller levels average neighbouring sprites into each other. Pass --mips
+// explicitly when the atlas is padded enough for the levels you keep.
+
+#include "renderer/cooked_texture_format.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+using namespace argon;
+
+namespace {
+
+	struct Image {
+		std::uint32_t w = 0, h = 0;
+		std::vector<std::uint8_t> rgba;
+	};
+
+	struct Rect {
+		std::string name;
+		std::int32_t x = 0, y = 0, w = 0, h = 0;
+	};
+
+	// 2x2 box filter; odd edges reuse the last row/column
+	Image downsample(const Image& src) {
+		Image dst;
+		dst.w = src.w > 1 ? src.w / 2 : 1;
+		dst.h = src.h > 1 ? src.h / 2 : 1;
+		dst.rgba.resize((std::size_t)dst.w * dst.h * 4);
+
+		for (std::uint32_t y = 0; y < dst.h; ++y) {
+			const std::uint32_t y0 = std::min(y * 2, src.h - 1);
+			const std::uint32_t y1 = std::min(y * 2 + 1, src.h - 1);
+			for (std::uint32_t x = 0; x < dst.w; ++x) {
+				const std::uint32_t x0 = std::min(x * 2, src.w - 1);
+				const std::uint32_t x1 = std::min(x * 2 + 1, src.w - 1);
+				const std::uint8_t* p00 = &src.rgba[((std::size_t)y0 * src.w + x0) * 4];
+				const std::uint8_t* p01 = &src.rgba[((std::size_t)y0 * src.w + x1) * 4];
+				const std::uint8_t* p10 = &src.rgba[((std::size_t)y1 * src.w + x0) * 4];
+				const std::uint8_t* p11 = &src.rgba[((std::size_t)y1 * src.w + x1) * 4];
+				std::uint8_t* out = &dst.rgba[((std::size_t)y * dst.w + x) * 4];
+				for (int c = 0; c < 4; ++c) {
+					out[c] = (std::uint8_t)((p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+				}
+			}
+		}
+		return dst;
+	}
+
+	// same grammar as TextureAtlas::loadFromFile
+	bool readAtlas(const std::string& path, std::vector<Rect>& out) {
+		std::ifstream in(path);
+		if (!in.is_open()) return false;
+
+		std::string line;
+		while (std::getline(in, line)) {
+			if (line.empty() || line[0] == '#') continue;
+			std::istringstream iss(line);
+			Rect r;
+			if (!(iss >> r.name >> r.x >> r.y >> r.w >> r.h)) continue;
+			if (r.w <= 0 || r.h <= 0) continue;
+			out.push_back(std::move(r));
+		}
+		return true;
+	}
+
+	std::uint64_t alignUp(std::uint64_t v, std::uint64_t a) {
+		return (v + a - 1) / a * a;
+	}
+
+	int usage() {
+		std::cerr << "usage: argon_cook <image> <out.atex> [--atlas <file.atlas>] [--mips <n>]\n"
+				  << "  --mips 0 full chain (default without --atlas), 1 base level only (default with --atlas)\n";
+		return 1;
+	}
+}
+
+int main(int argc, char** argv) {
+	if (argc < 3) return usage();
+
+	const std::string imagePath = argv[1];
+	const std::string outPath = argv[2];
+	std::string atlasPath;
+	std::uint32_t maxMips = 0;
+	bool mipsGiven = false;
+
+	for (int i = 3; i < argc; ++i) {
+		const std::string arg = argv[i];
+		if (arg == "--atlas" && i + 1 < argc) atlasPath = argv[++i];
+		else if (arg == "--mips" && i + 1 < argc) {
+			maxMips = (std::uint32_t)std::strtoul(argv[++i], nullptr, 10);
+			mipsGiven = true;
+		}
+		else return usage();
+	}
+	// sprites packed edge to edge bleed into each other in downsampled levels
+	if (!atlasPath.empty() && !mipsGiven) maxMips = 1;
+
+	int w = 0, h = 0, channels = 0;
+	stbi_set_flip_vertically_on_load(1);
+	unsigned char* pixels = stbi_load(imagePath.c_str(), &w, &h, &channels, 4);
+	if (!pixels) {
+		std::cerr << "argon_cook: failed to load " << imagePath << ": " << stbi_failure_reason() << "\n";
+		return 1;
+	}
+
+	std::vector<Image> mips(1);
+	mips[0].w = (std::uint32_t)w;
+	mips[0].h = (std::uint32_t)h;
+	mips[0].rgba.assign(pixels, pixels + (std::size_t)w * h * 4);
+	stbi_image_free(pixels);
+
+	while (maxMips == 0 || mips.size() < maxMips) {
+		const Image& last = mips.back();
+		if (last.w == 1 && last.h == 1) break;
+		mips.push_back(downsample(last));
+	}
+
+	std::vector<Rect> rects;
+	if (!atlasPath.empty() && !readAtlas(atlasPath, rects)) {
+		std::cerr << "argon_cook: failed to read atlas " << atlasPath << "\n";
+		return 1;
+	}
+
+	std::string names;
+	std::vector<cooked::RectEntry> rectTable;
+	rectTable.reserve(rects.size());
+	for (const Rect& r : rects) {
+		cooked::RectEntry e;
+		e.nameOffset = (std::uint32_t)names.size();
+		e.nameLength = (std::uint32_t)r.name.size();
+		e.x = r.x; e.y = r.y; e.w = r.w; e.h = r.h;
+		names += r.name;
+		rectTable.push_back(e);
+	}
+
+	cooked::FileHeader header;
+	header.width = mips[0].w;
+	header.height = mips[0].h;
+	header.mipCount = (std::uint32_t)mips.size();
+	header.rectCount = (std::uint32_t)rectTable.size();
+	header.mipTableOffset = sizeof(cooked::FileHeader);
+	header.rectTableOffset = header.mipTableOffset + mips.size() * sizeof(cooked::MipEntry);
+	header.nameTableOffset = header.rectTableOffset + rectTable.size() * sizeof(cooked::RectEntry);
+	header.nameTableSize = names.size();
+
+	std::vector<cooked::MipEntry> mipTable(mips.size());
+	std::uint64_t cursor = header.nameTableOffset + header.nameTableSize;
+	for (std::size_t i = 0; i < mips.size(); ++i) {
+		cursor = alignUp(cursor, cooked::kDataAlignment);
+		mipTable[i].offset = cursor;
+		mipTable[i].size = mips[i].rgba.size();
+		mipTable[i].width = mips[i].w;
+		mipTable[i].height = mips[i].h;
+		cursor += mipTable[i].size;
+	}
+
+	std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+	if (!out.is_open()) {
+		std::cerr << "argon_cook: cannot write " << outPath << "\n";
+		return 1;
+	}
+
+	auto writeAt = [&](std::uint64_t offset, const void* data, std::size_t size) {
+		// zero padding up to the aligned offset
+		static const char zeros[cooked::kDataAlignment] = {};
+		const std::uint64_t pos = (std::uint64_t)out.tellp();
+		out.write(zeros, (std::streamsize)(offset - pos));
+		out.write((const char*)data, (std::streamsize)size);
+	};
+
+	writeAt(0, &header, sizeof(header));
+	writeAt(header.mipTableOffset, mipTable.data(), mipTable.size() * sizeof(cooked::MipEntry));
+	writeAt(header.rectTableOffset, rectTable.data(), rectTable.size() * sizeof(cooked::RectEntry));
+	writeAt(header.nameTableOffset, names.data(), names.size());
+	for (std::size_t i = 0; i < mips.size(); ++i) {
+		writeAt(mipTable[i].offset, mips[i].rgba.data(), mips[i].rgba.size());
+	}
+
+	if (!out.good()) {
+		std::cerr << "argon_cook: write failed for " << outPath << "\n";
+		return 1;
+	}
+
+	std::cout << "argon_cook: " << outPath << " " << header.width << "x" << header.height
+		<< ", " << header.mipCount << " mips, " << header.rectCount << " rects, "
+		<< cursor << " bytes\n";
+	return 0;
+}